@@ -0,0 +1,264 @@
+/**
+ * @file		app_anim.c
+ * @brief		用于定义操作该模块的函数
+ * @note		关键帧动画模块：点阵与转向灯亮度
+ * @author	王广平
+ *
+ * @note
+ * 1) 插值全部用整数：关键帧之间的比例为 Q12 定点数，缓动曲线
+ *    f^2 * (3 - 2f) 同样在 Q12 下计算，32 位乘法不会溢出。
+ * 2) 帧节拍由一个自动重装的软件定时器产生，回调只置 SIG_ANIM_FRAME；
+ *    渲染在显示线程里按 xTaskGetTickCount() 计算动画时间，节拍晚到
+ *    不会让动画变慢，只会跳帧（计入 late）。
+ * 3) 每帧渲染用 DWT->CYCCNT 计时，调试命令 anim 查看统计。
+ * 4) app_anim_play/stop/step 只在显示线程中调用，统计另由调试线程读取。
+ */
+
+#define __APP_ANIM_C
+
+/* 头文件引用 */
+#include "app_anim.h"
+#include "FreeRTOS.h"
+#include "app_debug.h"
+#include "event_bus.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ANIM_FRAC_ONE (1UL << ANIM_FRAC_BITS)
+#define ANIM_PERIOD_MS (1000U / APP_ANIM_FPS)
+
+/* 帧节拍定时器 */
+static TimerHandle_t anim_timer = NULL;
+
+/* 播放状态（仅显示线程访问） */
+static const app_anim_seq_t *anim_seq = NULL;
+static TickType_t anim_start = 0;
+static u32 anim_frame_no = 0; /* 上一次渲染的帧序号 */
+
+/* 帧耗时统计（调试线程读取） */
+static app_anim_stats_t anim_stats = {0};
+
+static void app_anim_timer_cb(TimerHandle_t timer)
+{
+  (void)timer;
+  (void)xEventGroupSetBits(event_bus_getHandle(), SIG_ANIM_FRAME);
+}
+
+s32 app_anim_eval(const app_anim_track_t *track, u32 t_ms)
+{
+  const app_anim_key_t *k = track->keys;
+  u32 n = track->count;
+  u32 i = 1;
+
+  if (k == NULL || n == 0U)
+    return 0;
+  if (t_ms <= k[0].t_ms)
+    return k[0].value;
+
+  /* 找到第一个晚于 t_ms 的关键帧 */
+  while (i < n && k[i].t_ms <= t_ms)
+    i++;
+  if (i >= n)
+    return k[n - 1U].value;
+  if (track->interp == APP_ANIM_STEP)
+    return k[i - 1U].value;
+
+  /* k[i-1].t_ms <= t_ms < k[i].t_ms，比例 f 为 Q12，取值 [0, 1) */
+  u32 span = (u32)k[i].t_ms - k[i - 1U].t_ms;
+  u32 f = ((t_ms - k[i - 1U].t_ms) << ANIM_FRAC_BITS) / span;
+  if (track->interp == APP_ANIM_EASE)
+    f = (((f * f) >> ANIM_FRAC_BITS) * (3UL * ANIM_FRAC_ONE - 2UL * f)) >>
+        ANIM_FRAC_BITS;
+
+  s32 d = (s32)k[i].value - k[i - 1U].value;
+  return k[i - 1U].value +
+         ((d * (s32)f + (s32)(ANIM_FRAC_ONE / 2U)) >> ANIM_FRAC_BITS);
+}
+
+/**
+ * @brief 截断到 0~255
+ */
+static inline u8 app_anim_u8(s32 v)
+{
+  return (v < 0) ? 0U : (v > 255) ? 255U : (u8)v;
+}
+
+/**
+ * @brief 图案水平位移，正值向行的低位移动
+ */
+static void app_anim_shift_rows(const u8 src[8], s32 shift, u8 out[8])
+{
+  for (u32 r = 0; r < 8U; r++)
+  {
+    if (shift >= 8 || shift <= -8)
+      out[r] = 0;
+    else if (shift >= 0)
+      out[r] = (u8)(src[r] >> shift);
+    else
+      out[r] = (u8)(src[r] << -shift);
+  }
+}
+
+/**
+ * @brief 按动画时间 t 渲染，只改写有轨道的通道
+ */
+static void app_anim_render(const app_anim_seq_t *seq, u32 t,
+                            app_anim_frame_t *f)
+{
+  const app_anim_track_t *tr = seq->track;
+
+  if (seq->bitmaps != NULL && seq->bitmap_count != 0U)
+  {
+    s32 idx = app_anim_eval(&tr[APP_ANIM_CH_BITMAP], t);
+    s32 shift = app_anim_eval(&tr[APP_ANIM_CH_SHIFT], t);
+    if (idx < 0)
+      idx = 0;
+    if (idx >= seq->bitmap_count)
+      idx = seq->bitmap_count - 1;
+    app_anim_shift_rows(seq->bitmaps[idx], shift, f->rows);
+  }
+  if (tr[APP_ANIM_CH_DOT_LEVEL].keys != NULL)
+    f->dot_level = app_anim_u8(app_anim_eval(&tr[APP_ANIM_CH_DOT_LEVEL], t));
+  if (tr[APP_ANIM_CH_LAMP_LEFT].keys != NULL)
+    f->lamp_left = app_anim_u8(app_anim_eval(&tr[APP_ANIM_CH_LAMP_LEFT], t));
+  if (tr[APP_ANIM_CH_LAMP_RIGHT].keys != NULL)
+    f->lamp_right = app_anim_u8(app_anim_eval(&tr[APP_ANIM_CH_LAMP_RIGHT], t));
+}
+
+u32 app_anim_step(app_anim_frame_t *frame)
+{
+  const app_anim_seq_t *seq = anim_seq;
+  u32 ret = 0;
+  u32 t = 0;
+
+  if (seq == NULL || frame == NULL)
+    return 0;
+
+  u32 c0 = DWT->CYCCNT;
+  u32 elapsed = (u32)(xTaskGetTickCount() - anim_start) * portTICK_PERIOD_MS;
+
+  /* 播完最后一轮时停在最后一帧 */
+  if (seq->loops != 0U && elapsed >= (u32)seq->length_ms * seq->loops)
+  {
+    t = seq->length_ms;
+    ret |= APP_ANIM_END;
+  }
+  else
+    t = elapsed % seq->length_ms;
+
+  app_anim_frame_t next = *frame;
+  app_anim_render(seq, t, &next);
+  if (memcmp(next.rows, frame->rows, sizeof(next.rows)) != 0)
+    ret |= APP_ANIM_DIRTY_ROWS;
+  if (next.dot_level != frame->dot_level)
+    ret |= APP_ANIM_DIRTY_LEVEL;
+  if (next.lamp_left != frame->lamp_left ||
+      next.lamp_right != frame->lamp_right)
+    ret |= APP_ANIM_DIRTY_LAMP;
+  *frame = next;
+
+  u32 cycles = DWT->CYCCNT - c0;
+
+  /* 相邻两次渲染的帧序号相差超过 1，说明中间的节拍没来得及处理 */
+  u32 no = elapsed / ANIM_PERIOD_MS;
+  taskENTER_CRITICAL();
+  anim_stats.frames++;
+  if ((ret & ~APP_ANIM_END) != 0U)
+    anim_stats.changed++;
+  if (no > anim_frame_no + 1U)
+    anim_stats.late += no - anim_frame_no - 1U;
+  anim_stats.last_cycles = cycles;
+  if (cycles > anim_stats.max_cycles)
+    anim_stats.max_cycles = cycles;
+  taskEXIT_CRITICAL();
+  anim_frame_no = no;
+
+  if ((ret & APP_ANIM_END) != 0U)
+    app_anim_stop();
+  return ret;
+}
+
+RESULT_RUN app_anim_play(const app_anim_seq_t *seq)
+{
+  if (seq == NULL || seq->length_ms == 0U)
+    return ERR_RUN_ERROR_UDIP;
+  if (anim_timer == NULL)
+    return ERR_RUN_ERROR_UNST;
+
+  anim_seq = seq;
+  anim_start = xTaskGetTickCount();
+  anim_frame_no = 0;
+
+  /* 定时器未运行时 xTimerReset 会启动它 */
+  if (xTimerReset(anim_timer, 0) != pdPASS)
+  {
+    anim_seq = NULL;
+    return ERR_RUN_ERROR_CALL;
+  }
+  (void)xEventGroupSetBits(event_bus_getHandle(), SIG_ANIM_FRAME);
+  return ERR_RUN_Finished;
+}
+
+void app_anim_stop()
+{
+  anim_seq = NULL;
+  if (anim_timer != NULL)
+    (void)xTimerStop(anim_timer, 0);
+}
+
+bool app_anim_running() { return anim_seq != NULL; }
+
+void app_anim_GetStats(app_anim_stats_t *out)
+{
+  if (out == NULL)
+    return;
+
+  taskENTER_CRITICAL();
+  *out = anim_stats;
+  taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 调试命令：anim [clr]
+ */
+static void app_anim_cmd(int argc, char *argv[])
+{
+  app_anim_stats_t st;
+
+  if (argc == 2 && strcmp(argv[1], "clr") == 0)
+  {
+    taskENTER_CRITICAL();
+    memset(&anim_stats, 0, sizeof(anim_stats));
+    taskEXIT_CRITICAL();
+  }
+  else if (argc != 1)
+  {
+    printf("usage: anim [clr]\r\n");
+    return;
+  }
+
+  app_anim_GetStats(&st);
+  printf("[ANIM] %s, fps=%u, frames=%lu, changed=%lu, late=%lu\r\n",
+         app_anim_running() ? "play" : "idle", APP_ANIM_FPS,
+         (unsigned long)st.frames, (unsigned long)st.changed,
+         (unsigned long)st.late);
+  printf("[ANIM] cycles last=%lu, max=%lu, budget=%lu\r\n",
+         (unsigned long)st.last_cycles, (unsigned long)st.max_cycles,
+         (unsigned long)(SystemCoreClock / APP_ANIM_FPS));
+}
+
+RESULT_Init app_anim_init()
+{
+  anim_timer = xTimerCreate("Anim", pdMS_TO_TICKS(ANIM_PERIOD_MS), pdTRUE,
+                            NULL, app_anim_timer_cb);
+  if (anim_timer == NULL)
+    return ERR_Init_ERROR_RTOS;
+
+  /* DWT 周期计数器只读取差值，不清零 */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  (void)app_debug_register_cmd(ANIM_CMD_NAME, app_anim_cmd);
+  return ERR_Init_Finished;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file		app_anim.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		关键帧动画模块：点阵与转向灯亮度
+ * @author	王广平
+ *
+ * @note
+ * 一段动画（app_anim_seq_t）由若干通道的关键帧轨道组成，每条轨道按时间
+ * 插值出该通道的值，渲染到帧缓冲区 app_anim_frame_t：
+ * - 点阵：图案下标、水平位移、感知亮度
+ * - 转向灯：左右感知亮度
+ * 没有轨道的通道保持帧缓冲区中的原值。帧节拍由一个软件定时器按
+ * APP_ANIM_FPS 产生（SIG_ANIM_FRAME），只在播放期间运行；显示线程收到
+ * 事件后调用 app_anim_step()，只把发生变化的部分送到硬件。
+ **/
+
+#ifndef __APP_ANIM_H
+#define __APP_ANIM_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+// clang-format off
+
+#define APP_ANIM_FPS				30U			/* 帧率 */
+
+/* app_anim_step() 返回值：本帧发生变化的部分 */
+#define APP_ANIM_DIRTY_ROWS		(1U << 0)	/* 点阵图案 */
+#define APP_ANIM_DIRTY_LEVEL	(1U << 1)	/* 点阵亮度 */
+#define APP_ANIM_DIRTY_LAMP		(1U << 2)	/* 转向灯亮度 */
+#define APP_ANIM_END					(1U << 7)	/* 本帧后动画播放结束 */
+
+#ifdef __APP_ANIM_C	/* 用于.c文件的宏 */
+
+#define ANIM_FRAC_BITS			12U			/* 插值比例的定点小数位数（Q12） */
+#define ANIM_CMD_NAME				"anim"	/* 调试命令 */
+
+#endif
+// clang-format on
+
+/* 插值方式 */
+typedef enum
+{
+  APP_ANIM_STEP = 0, /* 保持前一关键帧的值 */
+  APP_ANIM_LINEAR,   /* 线性 */
+  APP_ANIM_EASE,     /* 两端缓动（smoothstep） */
+} app_anim_interp_t;
+
+/* 动画通道 */
+typedef enum
+{
+  APP_ANIM_CH_BITMAP = 0, /* 图案下标（app_anim_seq_t.bitmaps） */
+  APP_ANIM_CH_SHIFT,      /* 水平位移，正值向行的低位移动，|值| >= 8 时移出 */
+  APP_ANIM_CH_DOT_LEVEL,  /* 点阵感知亮度 0~255 */
+  APP_ANIM_CH_LAMP_LEFT,  /* 左转向灯感知亮度 0~255 */
+  APP_ANIM_CH_LAMP_RIGHT, /* 右转向灯感知亮度 0~255 */
+  APP_ANIM_CH_NUM,
+} app_anim_channel_t;
+
+/* 关键帧 */
+typedef struct
+{
+  u16 t_ms;  /* 相对一轮起点的时间，同一轨道内递增 */
+  s16 value; /* 通道值，渲染时按通道范围截断 */
+} app_anim_key_t;
+
+/* 一个通道的关键帧轨道 */
+typedef struct
+{
+  const app_anim_key_t *keys; /* NULL 表示不驱动该通道 */
+  u8 count;
+  app_anim_interp_t interp;
+} app_anim_track_t;
+
+/* 一段动画 */
+typedef struct
+{
+  const u8 (*bitmaps)[8]; /* 图案表（逻辑方向），NULL 时不改写点阵 */
+  u8 bitmap_count;
+  u16 length_ms; /* 一轮时长 */
+  u8 loops;      /* 播放轮数，0 为循环播放直到 app_anim_stop() */
+  app_anim_track_t track[APP_ANIM_CH_NUM];
+} app_anim_seq_t;
+
+/* 帧缓冲区 */
+typedef struct
+{
+  u8 rows[8];   /* 点阵图案（逻辑方向，未旋转） */
+  u8 dot_level; /* 点阵感知亮度，经 app_lut_max7219 换算成亮度寄存器 */
+  u8 lamp_left; /* 转向灯感知亮度，见 app_trunL_set_level() */
+  u8 lamp_right;
+} app_anim_frame_t;
+
+/* 帧耗时统计 */
+typedef struct
+{
+  u32 frames;      /* 渲染帧数 */
+  u32 changed;     /* 其中有输出变化的帧数 */
+  u32 late;        /* 来不及渲染而跳过的帧数 */
+  u32 last_cycles; /* 最近一帧渲染耗时（CPU 周期） */
+  u32 max_cycles;  /* 最大渲染耗时 */
+} app_anim_stats_t;
+
+/* 函数声明 */
+
+/**
+ * @brief		初始化动画模块
+ * @return	初始化结果
+ * @note		创建帧节拍定时器（不启动），打开 DWT 周期计数器，注册调试命令
+ **/
+RESULT_Init app_anim_init();
+
+/**
+ * @brief		开始播放一段动画
+ * @param		seq	动画，需在播放期间保持有效（通常为 const）
+ * @return	运行结果
+ * @note		正在播放的动画被替换，从第 0 ms 开始，第一帧立即触发
+ **/
+RESULT_RUN app_anim_play(const app_anim_seq_t *seq);
+
+/**
+ * @brief		停止播放
+ * @note		帧缓冲区保持最后一帧
+ **/
+void app_anim_stop();
+
+/**
+ * @brief		是否正在播放
+ **/
+bool app_anim_running();
+
+/**
+ * @brief		按当前时间渲染一帧
+ * @param		frame	帧缓冲区，保存上一次输出的内容
+ * @return	APP_ANIM_DIRTY_* 的组合，另外在最后一帧带 APP_ANIM_END
+ * @note		收到 SIG_ANIM_FRAME 时由显示线程调用；只改写动画驱动的通道
+ **/
+u32 app_anim_step(app_anim_frame_t *frame);
+
+/**
+ * @brief		计算一条轨道在某时刻的值
+ * @param		track	轨道
+ * @param		t_ms	相对一轮起点的时间
+ * @return	插值结果，早于第一帧取第一帧的值，晚于最后一帧取最后一帧的值
+ **/
+s32 app_anim_eval(const app_anim_track_t *track, u32 t_ms);
+
+/**
+ * @brief		获取帧耗时统计
+ * @param		out	输出
+ * @note		每帧渲染预算为 SystemCoreClock / APP_ANIM_FPS 个周期
+ **/
+void app_anim_GetStats(app_anim_stats_t *out);
+
+#endif
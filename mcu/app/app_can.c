@@ -14,6 +14,8 @@
  *    - doc/datasheet/can总线通信帧格式.png
  *    - 其中 Byte2 表示“点阵灯的模式”：
  *      0x00 加速，0x01 减速，0x02 停车，0x03 正常
+ *    - Byte3 在协议中预留扩展用，这里约定为“转向灯模式”（只在 DLC >= 4 时解析）：
+ *      0x00 跟随转向，0x01 双闪，0x02 灯泡故障（快闪），其余值忽略
  */
 
 #define __APP_CAN_C
@@ -67,6 +69,30 @@
 #define APP_CAN_SELF_TEST_PERIOD_MS 1000
 #endif
 
+/**
+ * @brief 将协议中的“转向灯模式”映射为共享状态
+ * @param mode 协议 Byte3 的值
+ * @param out  对应的转向灯模式
+ * @return 是否为有效值
+ */
+static inline bool app_can_mode_to_lamp(uint8_t mode, app_lamp_mode_t *out)
+{
+  switch (mode)
+  {
+  case BSP_CAN_LAMP_MODE_NORMAL:
+    *out = APP_LAMP_NORMAL;
+    return true;
+  case BSP_CAN_LAMP_MODE_HAZARD:
+    *out = APP_LAMP_HAZARD;
+    return true;
+  case BSP_CAN_LAMP_MODE_FAULT:
+    *out = APP_LAMP_FAULT;
+    return true;
+  default:
+    return false;
+  }
+}
+
 /**
  * @brief 将协议中的“点阵灯模式”映射为共享状态
  * @param mode 协议 Byte2 的值
@@ -97,6 +123,7 @@ void app_can_dispose_Task(void)
 {
   EventGroupHandle_t evt = event_bus_getHandle();
   app_motion_mode_t current_mode = APP_MOTION_NORMAL;
+  app_lamp_mode_t current_lamp = APP_LAMP_NORMAL;
 
   /* 用于控制“无报文时”的错误打印频率 */
   TickType_t last_err_print_tick = 0;
@@ -223,6 +250,18 @@ void app_can_dispose_Task(void)
       xEventGroupSetBits(evt, SIG_DISPLAY_UPDATE);
     }
 
+    /* Byte3：转向灯模式，由转向灯任务统一调度 */
+    app_lamp_mode_t want_lamp;
+    if (msg.len > BSP_CAN_CMD_BYTE_LAMP_MODE &&
+        app_can_mode_to_lamp(msg.data[BSP_CAN_CMD_BYTE_LAMP_MODE],
+                             &want_lamp) &&
+        want_lamp != current_lamp)
+    {
+      current_lamp = want_lamp;
+      app_state_update_lamp(current_lamp);
+      xEventGroupSetBits(evt, SIG_LAMP_UPDATE);
+    }
+
     /* 可选：给调试/统计用的“收到CAN帧”事件 */
     xEventGroupSetBits(evt, SIG_CAN_RX);
 
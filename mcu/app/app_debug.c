@@ -8,15 +8,36 @@
 
 /* 头文件引用 */
 #include "app_debug.h"
+#include "FreeRTOS.h"
+#include "__port_type__.h"
 #include "bsp_gpio.h"
 #include "bsp_usart.h"
 #include "stdio.h"
 #include "stm32f1xx_hal_gpio.h"
 #include "stm32f1xx_hal_uart.h"
+#include "string.h"
+#include "task.h"
+#include <stdbool.h>
 
 /* 静态全局变量 */
 static UART_HandleTypeDef Debug_USART = {0};
 
+/* 命令行接收：中断写 rx_line，收满一行后置 rx_ready，线程取走后清除 */
+static char rx_line[Debug_LINE_MAX];
+static u32 rx_len = 0;
+static volatile bool rx_ready = false;
+static TaskHandle_t debug_task = NULL;
+
+/* 命令表 */
+typedef struct
+{
+  const char *name;
+  app_debug_cmd_fn fn;
+} app_debug_cmd_t;
+
+static app_debug_cmd_t cmd_table[Debug_CMD_MAX];
+static u32 cmd_count = 0;
+
 /**
  * @brief		重定向printf函数
  * @date		2025/11/12
@@ -44,9 +65,131 @@ RESULT_Init app_debug_init()
 
   /* 初始化USART */
   ret = bsp_usart_init(&Debug_USART, Debug_USARTx, Debug_BRate);
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  /* 打开接收中断，用于调试命令行（USART1 中断优先级为 6，可调用 FromISR） */
+  __HAL_UART_ENABLE_IT(&Debug_USART, UART_IT_RXNE);
   return ret;
 }
 
+RESULT_RUN app_debug_register_cmd(const char *name, app_debug_cmd_fn fn)
+{
+  if (name == NULL || fn == NULL)
+    return ERR_RUN_ERROR_UDIP;
+  if (cmd_count >= Debug_CMD_MAX)
+    return ERR_RUN_BUSY;
+
+  cmd_table[cmd_count].name = name;
+  cmd_table[cmd_count].fn = fn;
+  cmd_count++;
+  return ERR_RUN_Finished;
+}
+
+void app_debug_dispose_ISP()
+{
+  USART_TypeDef *usart = Debug_USART.Instance;
+  BaseType_t woken = pdFALSE;
+
+  if (usart == NULL)
+    return;
+
+  /* 先读 SR 再读 DR，可同时清除 RXNE 与 ORE */
+  u32 sr = usart->SR;
+  if ((sr & (USART_SR_RXNE | USART_SR_ORE)) == 0U)
+    return;
+  char ch = (char)(usart->DR & 0xFFU);
+
+  /* 上一行还没被线程取走时丢弃新字符 */
+  if (rx_ready)
+    return;
+
+  if (ch == '\r' || ch == '\n')
+  {
+    if (rx_len == 0U)
+      return;
+    rx_line[rx_len] = '\0';
+    rx_len = 0;
+    rx_ready = true;
+    if (debug_task != NULL)
+    {
+      vTaskNotifyGiveFromISR(debug_task, &woken);
+      portYIELD_FROM_ISR(woken);
+    }
+    return;
+  }
+
+  /* 超长的行截断 */
+  if (rx_len < Debug_LINE_MAX - 1U)
+    rx_line[rx_len++] = ch;
+}
+
+void app_debug_dispose_Task()
+{
+  char line[Debug_LINE_MAX];
+  char *argv[Debug_ARGC_MAX];
+  int argc = 0;
+  u32 i = 0;
+
+  debug_task = xTaskGetCurrentTaskHandle();
+
+  while (1)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (!rx_ready)
+      continue;
+
+    memcpy(line, rx_line, sizeof(line));
+    rx_ready = false;
+
+    /* 按空格分割参数，每个参数后补结束符；参数过多时整行拒绝 */
+    argc = 0;
+    char *p = line;
+    bool too_many = false;
+    while (1)
+    {
+      while (*p == ' ')
+        p++;
+      if (*p == '\0')
+        break;
+      if (argc == Debug_ARGC_MAX)
+      {
+        too_many = true;
+        break;
+      }
+      argv[argc++] = p;
+      while (*p != '\0' && *p != ' ')
+        p++;
+      if (*p == ' ')
+        *p++ = '\0';
+    }
+    if (argc == 0)
+      continue;
+    if (too_many)
+    {
+      printf("[DBG] too many args (max %d): %s\r\n", Debug_ARGC_MAX - 1,
+             argv[0]);
+      continue;
+    }
+
+    for (i = 0; i < cmd_count; i++)
+    {
+      if (strcmp(argv[0], cmd_table[i].name) == 0)
+      {
+        cmd_table[i].fn(argc, argv);
+        break;
+      }
+    }
+    if (i == cmd_count)
+    {
+      printf("[DBG] unknown cmd: %s, cmds:", argv[0]);
+      for (i = 0; i < cmd_count; i++)
+        printf(" %s", cmd_table[i].name);
+      printf("\r\n");
+    }
+  }
+}
+
 void ERR_ShowBy_USART_RUN(RESULT_RUN res_run)
 {
   if (res_run != ERR_RUN_Finished)
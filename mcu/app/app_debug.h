@@ -18,9 +18,20 @@
 #define Debug_USARTx	USART1			/* 指定串口通道 */
 #define Debug_BRate		115200			/* 指定串口波特率 */
 
+#define Debug_LINE_MAX	48					/* 命令行最大长度（含结束符） */
+#define Debug_ARGC_MAX	4						/* 单条命令最多参数个数（含命令名） */
+#define Debug_CMD_MAX		4						/* 最多可注册的命令数 */
+
 // clang-format on
 #endif
 
+/**
+ * @brief 调试命令处理函数
+ * @param argc 参数个数（argv[0] 为命令名）
+ * @param argv 以空格分割后的参数
+ */
+typedef void (*app_debug_cmd_fn)(int argc, char *argv[]);
+
 /* 函数声明 */
 
 /**
@@ -48,4 +59,24 @@ void ERR_ShowBy_USART_RUN(RESULT_RUN res_run);
  */
 void ERR_ShowBy_USART_Init(RESULT_Init res_init);
 
+/**
+ * @brief   注册调试串口命令
+ * @param   name	命令名（需为常量字符串）
+ * @param   fn		处理函数，在调试线程中调用
+ * @return  运行结果，命令表已满时返回 ERR_RUN_BUSY
+ */
+RESULT_RUN app_debug_register_cmd(const char *name, app_debug_cmd_fn fn);
+
+/**
+ * @brief   串口接收中断处理函数
+ * @note    逐字节收集一行，收到回车/换行后通知调试线程
+ */
+void app_debug_dispose_ISP();
+
+/**
+ * @brief   调试线程处理函数
+ * @note    解析一行命令并分发到已注册的处理函数
+ */
+void app_debug_dispose_Task();
+
 #endif
\ No newline at end of file
@@ -17,6 +17,7 @@ typedef enum
   DISPLAY_DOWN,
   DISPLAY_STOP,
   DISPLAY_START,
+  DISPLAY_PATTERN_NUM,
 } display_pattern_t;
 
 display_pattern_t app_display_policy_resolve(
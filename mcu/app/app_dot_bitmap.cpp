@@ -0,0 +1,142 @@
+/**
+ * @file		app_dot_bitmap.cpp
+ * @brief		用于定义操作该模块的函数
+ * @note		点阵图案表
+ * @author	王广平
+ *
+ * @note
+ * 旋转与镜像都是 constexpr 函数，安装方向换算后的图案表在编译期生成，
+ * 启动时不再复制和逐位旋转；新增图案只需在 DOT_LOGICAL 中追加一项，
+ * 不增加 RAM。
+ */
+
+#define __APP_DOT_BITMAP_C
+
+/* 头文件引用 */
+#include "app_dot_bitmap.h"
+#include "app_dot_displayer.h"
+
+namespace
+{
+
+struct dot_bitmap
+{
+  u8 r[8];
+};
+
+/* 顺时针旋转 90°：新第 r 行取原图第 r 列（自下而上） */
+constexpr dot_bitmap dot_turn_once(const dot_bitmap &in)
+{
+  dot_bitmap out{};
+  for (u32 r = 0; r < 8; r++)
+  {
+    u8 new_row = 0;
+    for (u32 c = 0; c < 8; c++)
+      new_row |= (u8)(((in.r[7 - c] >> r) & 1U) << (7 - c));
+    out.r[r] = new_row;
+  }
+  return out;
+}
+
+/* 左右镜像：每行位序反转 */
+constexpr dot_bitmap dot_mirror(const dot_bitmap &in)
+{
+  dot_bitmap out{};
+  for (u32 r = 0; r < 8; r++)
+  {
+    u8 v = 0;
+    for (u32 b = 0; b < 8; b++)
+      v |= (u8)(((in.r[r] >> b) & 1U) << (7 - b));
+    out.r[r] = v;
+  }
+  return out;
+}
+
+/* 逻辑方向 -> 安装方向：先镜像，再旋转 APP_DOTD_TURN_COUNT 次 */
+constexpr dot_bitmap dot_to_panel(dot_bitmap b)
+{
+  if (APP_DOTD_MIRROR != 0U)
+    b = dot_mirror(b);
+  for (u32 i = 0; i < (APP_DOTD_TURN_COUNT & 3U); i++)
+    b = dot_turn_once(b);
+  return b;
+}
+
+static_assert(DISPLAY_PATTERN_NUM == 7, "DOT_LOGICAL must list every pattern");
+
+/* 按 display_pattern_t 顺序排列 */
+constexpr app_dotB_table_t DOT_LOGICAL = {{
+    /* DISPLAY_NONE */
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    /* DISPLAY_LEFT */
+    {0b00011000, 0b00011100, 0b11111110, 0b11111111, 0b11111110, 0b00011100,
+     0b00011000, 0b00000000},
+    /* DISPLAY_RIGHT */
+    {0b00011000, 0b00111000, 0b01111111, 0b11111111, 0b01111111, 0b00111000,
+     0b00011000, 0b00000000},
+    /* DISPLAY_UP */
+    {0b00011000, 0b00111100, 0b00111100, 0b00011000, 0b00000000, 0b00011000,
+     0b00011000, 0b00000000},
+    /* DISPLAY_DOWN */
+    {0b00000000, 0b00011000, 0b00011000, 0b00000000, 0b00011000, 0b00111100,
+     0b00111100, 0b00011000},
+    /* DISPLAY_STOP */
+    {0b11111100, 0b10000110, 0b10000110, 0b11111100, 0b10000000, 0b10000000,
+     0b10000000, 0b00000000},
+    /* DISPLAY_START */
+    {0b00000000, 0b01000010, 0b11100111, 0b00000000, 0b00000000, 0b10000001,
+     0b01111110, 0b00000000},
+}};
+
+constexpr dot_bitmap dot_get(const app_dotB_table_t &t, u32 i)
+{
+  dot_bitmap b{};
+  for (u32 r = 0; r < 8; r++)
+    b.r[r] = t.v[i][r];
+  return b;
+}
+
+constexpr app_dotB_table_t make_panel()
+{
+  app_dotB_table_t t{};
+  for (u32 i = 0; i < DISPLAY_PATTERN_NUM; i++)
+  {
+    dot_bitmap b = dot_to_panel(dot_get(DOT_LOGICAL, i));
+    for (u32 r = 0; r < 8; r++)
+      t.v[i][r] = b.r[r];
+  }
+  return t;
+}
+
+constexpr bool dot_equal(const dot_bitmap &a, const dot_bitmap &b)
+{
+  for (u32 r = 0; r < 8; r++)
+    if (a.r[r] != b.r[r])
+      return false;
+  return true;
+}
+
+constexpr dot_bitmap DOT_ARROW = dot_get(DOT_LOGICAL, DISPLAY_LEFT);
+
+static_assert(dot_equal(dot_turn_once(dot_turn_once(dot_turn_once(
+                            dot_turn_once(DOT_ARROW)))),
+                        DOT_ARROW),
+              "four turns are identity");
+static_assert(dot_equal(dot_mirror(dot_mirror(DOT_ARROW)), DOT_ARROW),
+              "mirroring twice is identity");
+
+} // namespace
+
+/* constinit：保证在编译期完成初始化，链接进 .rodata（flash） */
+constinit const app_dotB_table_t app_dotB_logical = DOT_LOGICAL;
+constinit const app_dotB_table_t app_dotB_panel = make_panel();
+
+void app_dotB_to_panel(const u8 in[8], u8 out[8])
+{
+  dot_bitmap b{};
+  for (u32 r = 0; r < 8; r++)
+    b.r[r] = in[r];
+  b = dot_to_panel(b);
+  for (u32 r = 0; r < 8; r++)
+    out[r] = b.r[r];
+}
@@ -0,0 +1,59 @@
+/**
+ * @file		app_dot_bitmap.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		点阵图案表
+ * @author	王广平
+ *
+ * @note
+ * 图案表由 app_dot_bitmap.cpp 在编译期生成，放在 flash 中，不占 RAM：
+ * - app_dotB_logical：逻辑方向的原始图案，供动画移位、合成后再旋转
+ * - app_dotB_panel：按 APP_DOTD_TURN_COUNT 旋转、按 APP_DOTD_MIRROR 镜像后
+ *   的图案，静态显示时直接送给 bsp_max7219
+ * 两张表都按 display_pattern_t 下标，DISPLAY_NONE 为全灭。
+ **/
+
+#ifndef __APP_DOT_BITMAP_H
+#define __APP_DOT_BITMAP_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+#include "app_display_policy.h"
+
+/* 宏定义 */
+
+/**
+ * @brief 是否左右镜像（在旋转之前进行）
+ * @note 点阵从背面观看或模块反装时置 1
+ */
+#ifndef APP_DOTD_MIRROR
+#define APP_DOTD_MIRROR 0U
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 图案表（flash） */
+typedef struct
+{
+  u8 v[DISPLAY_PATTERN_NUM][8]; /* [图案][行]，每行高位在前 */
+} app_dotB_table_t;
+
+extern const app_dotB_table_t app_dotB_logical;
+extern const app_dotB_table_t app_dotB_panel;
+
+/* 函数声明 */
+
+/**
+ * @brief		把逻辑方向的一帧换算成点阵安装方向
+ * @param		in	逻辑方向的 8 行（如动画合成结果）
+ * @param		out	输出
+ * @note		与生成 app_dotB_panel 的是同一个 constexpr 变换，只用于运行时合成的帧
+ **/
+void app_dotB_to_panel(const u8 in[8], u8 out[8]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
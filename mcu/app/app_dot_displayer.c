@@ -6,7 +6,11 @@
 
 #include "app_dot_displayer.h"
 #include "FreeRTOS.h"
+#include "app_anim.h"
 #include "app_display_policy.h"
+#include "app_dot_bitmap.h"
+#include "app_dot_scroll.h"
+#include "app_lut.h"
 #include "app_state.h"
 #include "bsp_max7219.h"
 #include "event_bus.h"
@@ -15,36 +19,68 @@
 #include <stdint.h>
 #include <string.h>
 
-static const uint8_t APP_DOTD_LEFT_ARROW[8] = {
-    0b00011000, 0b00011100, 0b11111110, 0b11111111,
-    0b11111110, 0b00011100, 0b00011000, 0b00000000};
-
-static const uint8_t APP_DOTD_RIGHT_ARROW[8] = {
-    0b00011000, 0b00111000, 0b01111111, 0b11111111,
-    0b01111111, 0b00111000, 0b00011000, 0b00000000};
-
-static const uint8_t APP_DOTD_START_PATTERN[8] = {
-    0b00000000, 0b01000010, 0b11100111, 0b00000000,
-    0b00000000, 0b10000001, 0b01111110, 0b00000000};
-
-static const uint8_t APP_DOTD_UP_PATTERN[8] = {
-    0b00011000, 0b00111100, 0b00111100, 0b00011000,
-    0b00000000, 0b00011000, 0b00011000, 0b00000000};
-
-static const uint8_t APP_DOTD_DOWN_PATTERN[8] = {
-    0b00000000, 0b00011000, 0b00011000, 0b00000000,
-    0b00011000, 0b00111100, 0b00111100, 0b00011000};
-
-static const uint8_t APP_DOTD_STOP_PATTERN[8] = {
-    0b11111100, 0b10000110, 0b10000110, 0b11111100,
-    0b10000000, 0b10000000, 0b10000000, 0b00000000};
+/* 动画：箭头沿所指方向滑入、停留、滑出，循环播放 */
+static const app_anim_key_t APP_DOTD_SLIDE_LEFT_KEYS[] = {
+    {0, -8}, {400, 0}, {800, 0}, {1000, 8}};
+static const app_anim_key_t APP_DOTD_SLIDE_RIGHT_KEYS[] = {
+    {0, 8}, {400, 0}, {800, 0}, {1000, -8}};
+
+static const app_anim_seq_t APP_DOTD_ANIM_LEFT = {
+    .bitmaps = &app_dotB_logical.v[DISPLAY_LEFT],
+    .bitmap_count = 1,
+    .length_ms = 1000,
+    .loops = 0,
+    .track = {[APP_ANIM_CH_SHIFT] = {APP_DOTD_SLIDE_LEFT_KEYS, 4,
+                                     APP_ANIM_EASE}},
+};
+
+static const app_anim_seq_t APP_DOTD_ANIM_RIGHT = {
+    .bitmaps = &app_dotB_logical.v[DISPLAY_RIGHT],
+    .bitmap_count = 1,
+    .length_ms = 1000,
+    .loops = 0,
+    .track = {[APP_ANIM_CH_SHIFT] = {APP_DOTD_SLIDE_RIGHT_KEYS, 4,
+                                     APP_ANIM_EASE}},
+};
+
+/* 动画：上电图案渐亮、停留、渐灭，播放一次 */
+static const app_anim_key_t APP_DOTD_FADE_KEYS[] = {
+    {0, 0}, {250, 255}, {450, 255}, {700, 0}};
+
+static const app_anim_seq_t APP_DOTD_ANIM_START = {
+    .bitmaps = &app_dotB_logical.v[DISPLAY_START],
+    .bitmap_count = 1,
+    .length_ms = 700,
+    .loops = 1,
+    .track = {[APP_ANIM_CH_DOT_LEVEL] = {APP_DOTD_FADE_KEYS, 4,
+                                         APP_ANIM_EASE}},
+};
+
+/* 最近一次送到硬件的动画帧与亮度寄存器，只发送有变化的部分 */
+static app_anim_frame_t app_dotD_frame = {
+    .dot_level = 255, .lamp_left = 255, .lamp_right = 255};
+static uint8_t app_dotD_intensity = 0x0F;
+static display_pattern_t app_dotD_shown = DISPLAY_NONE;
+static bool app_dotD_rows_stale = false; /* 点阵显示的是静态图案而非动画帧 */
+
+/* 滚动文字帧（逻辑方向，[片][行]） */
+static uint8_t app_dotD_text[APP_DOTS_DEVICES][8];
+
+/* 异步帧发送完成时通知点阵任务 */
+static TaskHandle_t app_dotD_task = NULL;
+
+/* 一帧最多 8 个寄存器，正常约 20us 发完，超时只作保护 */
+#define APP_DOTD_TX_TIMEOUT_MS 5U
+
+static void app_dotD_tx_done(void)
+{
+  BaseType_t woken = pdFALSE;
 
-static uint8_t app_dotD_LEFT[8];
-static uint8_t app_dotD_RIGHT[8];
-static uint8_t app_dotD_START[8];
-static uint8_t app_dotD_UP[8];
-static uint8_t app_dotD_DOWN[8];
-static uint8_t app_dotD_STOP[8];
+  if (app_dotD_task == NULL)
+    return;
+  vTaskNotifyGiveFromISR(app_dotD_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
 
 #ifndef APP_DOTD_DEBUG_PRINT
 #define APP_DOTD_DEBUG_PRINT 1
@@ -54,95 +90,106 @@ static uint8_t app_dotD_STOP[8];
 #define APP_DOTD_POWERON_TEST 1
 #endif
 
-#if APP_DOTD_TURN_COUNT > 0U
-static RESULT_RUN app_dotD_turn_once(const uint8_t old[8], uint8_t out[8])
+/* 周期性按影子寄存器整屏重写，干扰改乱芯片寄存器后可自行恢复；0 关闭 */
+#ifndef APP_DOTD_REFRESH_MS
+#define APP_DOTD_REFRESH_MS 5000U
+#endif
+
+/**
+ * @brief 静态显示一个图案，直接读取 flash 中已换算安装方向的图案表
+ */
+static RESULT_RUN app_dotD_render_pattern(display_pattern_t pattern)
 {
-  uint8_t r = 0;
+  if ((uint32_t)pattern >= DISPLAY_PATTERN_NUM)
+    pattern = DISPLAY_NONE;
+  return bsp_max7219_write_rows(app_dotB_panel.v[pattern]);
+}
 
-  if (old == NULL || out == NULL)
-    return ERR_RUN_ERROR_UDIP;
+/**
+ * @brief 等待上一帧异步发送结束
+ * @note
+ * 新帧在上一帧发送期间已经渲染好，这里才等上一帧发完；
+ * 提交前清掉旧通知，之后收到的通知只属于本帧
+ */
+static void app_dotD_wait_tx(void)
+{
+  if (bsp_max7219_busy())
+    (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(APP_DOTD_TX_TIMEOUT_MS));
+  (void)ulTaskNotifyTake(pdTRUE, 0);
+}
 
-  for (r = 0; r < 8; r++)
+/**
+ * @brief 把动画帧中变化的部分送到点阵和转向灯
+ * @param dirty app_anim_step() 的返回值
+ */
+static RESULT_RUN app_dotD_push_frame(uint32_t dirty)
+{
+  RESULT_RUN ret = ERR_RUN_Finished;
+
+  /* 多个感知亮度对应同一寄存器值，寄存器不变时不发送 */
+  if ((dirty & APP_ANIM_DIRTY_LEVEL) != 0U)
   {
-    uint8_t c = 0;
-    uint8_t new_row = 0;
-    for (c = 0; c < 8; c++)
+    uint8_t intensity = app_lut_max7219.v[app_dotD_frame.dot_level];
+    if (intensity != app_dotD_intensity)
     {
-      uint8_t bit = (old[7 - c] >> r) & 1U;
-      new_row |= (uint8_t)(bit << (7 - c));
+      ret = bsp_max7219_set_intensity(intensity);
+      app_dotD_intensity = intensity;
     }
-    out[r] = new_row;
   }
 
-  return ERR_RUN_Finished;
-}
-#endif
-
-static RESULT_Init app_dotD_pattern_init(void)
-{
-  memcpy(app_dotD_LEFT, APP_DOTD_LEFT_ARROW, sizeof(app_dotD_LEFT));
-  memcpy(app_dotD_RIGHT, APP_DOTD_RIGHT_ARROW, sizeof(app_dotD_RIGHT));
-  memcpy(app_dotD_START, APP_DOTD_START_PATTERN, sizeof(app_dotD_START));
-  memcpy(app_dotD_UP, APP_DOTD_UP_PATTERN, sizeof(app_dotD_UP));
-  memcpy(app_dotD_DOWN, APP_DOTD_DOWN_PATTERN, sizeof(app_dotD_DOWN));
-  memcpy(app_dotD_STOP, APP_DOTD_STOP_PATTERN, sizeof(app_dotD_STOP));
-
-#if APP_DOTD_TURN_COUNT > 0U
-  uint8_t i = 0;
-
-  for (i = 0; i < APP_DOTD_TURN_COUNT; i++)
+  if ((dirty & APP_ANIM_DIRTY_ROWS) != 0U)
   {
-    uint8_t tmp[8];
-
-    if (app_dotD_turn_once(app_dotD_LEFT, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_LEFT, tmp, sizeof(tmp));
-
-    if (app_dotD_turn_once(app_dotD_RIGHT, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_RIGHT, tmp, sizeof(tmp));
-
-    if (app_dotD_turn_once(app_dotD_START, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_START, tmp, sizeof(tmp));
+    /* 动画帧在运行时合成，按逻辑方向渲染后再换算安装方向 */
+    uint8_t rows[8];
+    app_dotB_to_panel(app_dotD_frame.rows, rows);
+    app_dotD_wait_tx();
+    ret = bsp_max7219_submit_rows(rows);
+  }
 
-    if (app_dotD_turn_once(app_dotD_UP, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_UP, tmp, sizeof(tmp));
+  /* 转向灯由转向灯线程驱动，亮度经共享状态转交 */
+  if ((dirty & APP_ANIM_DIRTY_LAMP) != 0U)
+  {
+    app_state_update_lamp_level(app_dotD_frame.lamp_left,
+                                app_dotD_frame.lamp_right);
+    (void)xEventGroupSetBits(event_bus_getHandle(), SIG_LAMP_UPDATE);
+  }
 
-    if (app_dotD_turn_once(app_dotD_DOWN, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_DOWN, tmp, sizeof(tmp));
+  return ret;
+}
 
-    if (app_dotD_turn_once(app_dotD_STOP, tmp) != ERR_RUN_Finished)
-      return ERR_Init_ERROR_SPI;
-    memcpy(app_dotD_STOP, tmp, sizeof(tmp));
-  }
-#endif
+/**
+ * @brief 把滚动文字帧送到整条级联点阵
+ * @note  各片换算安装方向后写入帧缓冲区，驱动按影子寄存器只发送有变化的行
+ */
+static RESULT_RUN app_dotD_push_text(void)
+{
+  uint8_t *fb = bsp_max7219_getFrame();
 
-  return ERR_Init_Finished;
+  for (uint32_t d = 0; d < APP_DOTS_DEVICES; d++)
+    app_dotB_to_panel(app_dotD_text[d], &fb[d * 8U]);
+  app_dotD_wait_tx();
+  return bsp_max7219_submit();
 }
 
-static RESULT_RUN app_dotD_render_pattern(display_pattern_t pattern)
+/**
+ * @brief 显示一个图案：箭头播放滑动动画，其余图案静态显示
+ */
+static RESULT_RUN app_dotD_show_pattern(display_pattern_t pattern)
 {
-  switch (pattern)
-  {
-  case DISPLAY_LEFT:
-    return bsp_max7219_write_rows(app_dotD_LEFT);
-  case DISPLAY_RIGHT:
-    return bsp_max7219_write_rows(app_dotD_RIGHT);
-  case DISPLAY_UP:
-    return bsp_max7219_write_rows(app_dotD_UP);
-  case DISPLAY_DOWN:
-    return bsp_max7219_write_rows(app_dotD_DOWN);
-  case DISPLAY_STOP:
-    return bsp_max7219_write_rows(app_dotD_STOP);
-  case DISPLAY_START:
-    return bsp_max7219_write_rows(app_dotD_START);
-  case DISPLAY_NONE:
-  default:
-    return bsp_max7219_clear();
-  }
+  if (pattern == DISPLAY_LEFT)
+    return app_anim_play(&APP_DOTD_ANIM_LEFT);
+  if (pattern == DISPLAY_RIGHT)
+    return app_anim_play(&APP_DOTD_ANIM_RIGHT);
+
+  app_anim_stop();
+
+  /* 静态图案按满亮度显示 */
+  app_dotD_frame.dot_level = 255;
+  RESULT_RUN ret = app_dotD_push_frame(APP_ANIM_DIRTY_LEVEL);
+  if (ret != ERR_RUN_Finished)
+    return ret;
+  app_dotD_rows_stale = true;
+  return app_dotD_render_pattern(pattern);
 }
 
 RESULT_Init app_dotD_Init(void)
@@ -151,13 +198,20 @@ RESULT_Init app_dotD_Init(void)
   if (ret != ERR_Init_Finished)
     return ret;
 
-  return app_dotD_pattern_init();
+  ret = app_anim_init();
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  return app_dotS_init();
 }
 
 void app_dotD_dispose_Task(void)
 {
   EventGroupHandle_t evt = event_bus_getHandle();
 
+  app_dotD_task = xTaskGetCurrentTaskHandle();
+  bsp_max7219_set_done_cb(app_dotD_tx_done);
+
 #if APP_DOTD_DEBUG_PRINT
   printf("[DOT] task start\r\n");
 #endif
@@ -168,22 +222,115 @@ void app_dotD_dispose_Task(void)
   (void)bsp_max7219_set_test_mode(false);
 #endif
 
-  (void)app_dotD_render_pattern(DISPLAY_START);
-  vTaskDelay(pdMS_TO_TICKS(200));
   (void)app_dotD_render_pattern(DISPLAY_NONE);
+  if (app_anim_play(&APP_DOTD_ANIM_START) == ERR_RUN_Finished)
+    app_dotD_shown = DISPLAY_START;
+
+#if APP_DOTD_REFRESH_MS > 0U
+  TickType_t refresh_tick = xTaskGetTickCount();
+#endif
 
   while (1)
   {
     app_state_snapshot_t snapshot;
     display_pattern_t pattern;
     RESULT_RUN show_ret;
+    EventBits_t bits;
+    bool force = false;
+
+    TickType_t wait = portMAX_DELAY;
+#if APP_DOTD_REFRESH_MS > 0U
+    TickType_t since = xTaskGetTickCount() - refresh_tick;
+    wait = (since < pdMS_TO_TICKS(APP_DOTD_REFRESH_MS))
+               ? (pdMS_TO_TICKS(APP_DOTD_REFRESH_MS) - since)
+               : 0;
+#endif
 
-    (void)xEventGroupWaitBits(evt, SIG_DISPLAY_UPDATE, pdTRUE, pdFALSE,
-                              portMAX_DELAY);
+    bits = xEventGroupWaitBits(
+        evt, SIG_DISPLAY_UPDATE | SIG_ANIM_FRAME | SIG_SCROLL_FRAME, pdTRUE,
+        pdFALSE, wait);
+
+#if APP_DOTD_REFRESH_MS > 0U
+    if ((xTaskGetTickCount() - refresh_tick) >=
+        pdMS_TO_TICKS(APP_DOTD_REFRESH_MS))
+    {
+      refresh_tick = xTaskGetTickCount();
+      show_ret = bsp_max7219_refresh();
+#if APP_DOTD_DEBUG_PRINT
+      if (show_ret != ERR_RUN_Finished)
+        printf("[DOT] refresh error=%d\r\n", (int)show_ret);
+#endif
+    }
+#endif
+
+    /* 滚动文字期间由文字占用点阵，动画与图案更新都暂缓 */
+    if ((bits & SIG_SCROLL_FRAME) != 0U)
+    {
+      bool was_active = app_dotS_active();
+      uint32_t dirty = app_dotS_step(app_dotD_text);
+
+      show_ret = ERR_RUN_Finished;
+      if (!was_active && app_dotS_active())
+      {
+        app_anim_stop();
+        app_dotD_frame.dot_level = 255;
+        show_ret = app_dotD_push_frame(APP_ANIM_DIRTY_LEVEL);
+      }
+      if ((dirty & APP_DOTS_DIRTY) != 0U && show_ret == ERR_RUN_Finished)
+        show_ret = app_dotD_push_text();
+#if APP_DOTD_DEBUG_PRINT
+      if (show_ret != ERR_RUN_Finished)
+        printf("[DOT] text error=%d\r\n", (int)show_ret);
+#endif
+      /* 文字可能停在中途，清屏后按当前状态重新显示 */
+      if ((dirty & APP_DOTS_END) != 0U)
+      {
+        (void)bsp_max7219_clear();
+        app_dotD_rows_stale = true;
+        bits |= SIG_DISPLAY_UPDATE;
+        force = true;
+      }
+    }
+
+    if (app_dotS_active())
+      continue;
+
+    if ((bits & SIG_ANIM_FRAME) != 0U)
+    {
+      /* 停止后残留的节拍事件不渲染 */
+      bool playing = app_anim_running();
+      uint32_t dirty = app_anim_step(&app_dotD_frame);
+      if (app_dotD_rows_stale && playing)
+      {
+        dirty |= APP_ANIM_DIRTY_ROWS;
+        app_dotD_rows_stale = false;
+      }
+      show_ret = app_dotD_push_frame(dirty);
+#if APP_DOTD_DEBUG_PRINT
+      if (show_ret != ERR_RUN_Finished)
+        printf("[DOT] frame error=%d\r\n", (int)show_ret);
+#endif
+      /* 上电动画播完后按当前状态显示 */
+      if ((dirty & APP_ANIM_END) != 0U)
+      {
+        bits |= SIG_DISPLAY_UPDATE;
+        force = true;
+      }
+    }
+
+    if ((bits & SIG_DISPLAY_UPDATE) == 0U)
+      continue;
 
     app_state_get_snapshot(&snapshot);
     pattern = app_display_policy_resolve(&snapshot);
-    show_ret = app_dotD_render_pattern(pattern);
+
+    /* 上电动画期间不打断；图案不变时不重复发送 */
+    if (app_anim_running() && app_dotD_shown == DISPLAY_START)
+      continue;
+    if (pattern == app_dotD_shown && !force)
+      continue;
+    app_dotD_shown = pattern;
+    show_ret = app_dotD_show_pattern(pattern);
 
 #if APP_DOTD_DEBUG_PRINT
     printf("[DOT] render=%d steer=%d motion=%d hint=%d\r\n", (int)pattern,
@@ -10,6 +10,10 @@
 /* 头文件引用 */
 #include "ERR.h"
 
+/**
+ * @brief 点阵安装方向：顺时针旋转 90° 的次数
+ * @note 图案表在 app_dot_bitmap.cpp 编译期按此旋转，修改须全工程一致（用 -D 定义）
+ */
 #ifndef APP_DOTD_TURN_COUNT
 #define APP_DOTD_TURN_COUNT 0U
 #endif
@@ -0,0 +1,38 @@
+/**
+ * @file		app_dot_font.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		点阵字库：5x7 ASCII 字模
+ * @author	王广平
+ *
+ * @note
+ * 字模按列存放（列优先），每字符 APP_DOTF_WIDTH 字节，每字节一列，
+ * bit0 为最上一行，bit6 为最下一行，bit7 不用。滚动显示时每帧只取
+ * 一列，按列存放省去逐行拆位；整张表 475 字节，放在 flash 中。
+ **/
+
+#ifndef __APP_DOT_FONT_H
+#define __APP_DOT_FONT_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+
+/* 宏定义 */
+// clang-format off
+
+#define APP_DOTF_WIDTH			5U			/* 字宽（列） */
+#define APP_DOTF_HEIGHT			7U			/* 字高（行） */
+#define APP_DOTF_FIRST			0x20U		/* 第一个字符（空格） */
+#define APP_DOTF_LAST				0x7EU		/* 最后一个字符（~） */
+
+// clang-format on
+
+/* 函数声明 */
+
+/**
+ * @brief		获取字符的字模
+ * @param		ch	ASCII 字符，字库之外的字符按 '?' 显示
+ * @return	APP_DOTF_WIDTH 列字模（flash）
+ **/
+const u8 *app_dotF_glyph(char ch);
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file		app_dot_scroll.c
+ * @brief		用于定义操作该模块的函数
+ * @note		点阵滚动文字
+ * @author	王广平
+ *
+ * @note
+ * 1) 文字展开成的列流不预先生成：用“当前字符 + 字符内列号”两个下标
+ *    逐列取字模，取一列是常数时间；文字之后再送 APP_DOTS_WIDTH 个空列，
+ *    让最后一个字符完整移出。
+ * 2) 窗口为环形缓冲区，移动一列只改写一个字节；同时维护窗口中非空列的
+ *    个数，窗口全灭且新列也为空时整帧不变，不合成也不发送。
+ * 3) 其他线程只通过请求（开始/停止）与显示线程交互，文字在临界区内复制，
+ *    滚动状态只由显示线程访问。
+ */
+
+#define __APP_DOT_SCROLL_C
+
+/* 头文件引用 */
+#include "app_dot_scroll.h"
+#include "FreeRTOS.h"
+#include "app_debug.h"
+#include "app_dot_font.h"
+#include "event_bus.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 跨线程请求 */
+typedef enum
+{
+  DOTS_REQ_NONE = 0,
+  DOTS_REQ_SHOW,
+  DOTS_REQ_STOP,
+} dotS_req_t;
+
+/* 帧节拍定时器 */
+static TimerHandle_t dotS_timer = NULL;
+
+/* 请求（任意线程写，显示线程取走） */
+static dotS_req_t dotS_req = DOTS_REQ_NONE;
+static char dotS_pending[APP_DOTS_MAX_LEN + 1U];
+static u8 dotS_pending_loops = 0;
+
+/* 滚动状态（仅显示线程访问） */
+static char dotS_text[APP_DOTS_MAX_LEN + 1U];
+static bool dotS_running = false;
+static u8 dotS_loops = 0;  /* 0 为循环 */
+static u8 dotS_rounds = 0; /* 已滚完的轮数 */
+static u32 dotS_pos = 0;   /* 当前字符下标 */
+static u32 dotS_col = 0;   /* 字符内列号，APP_DOTF_WIDTH 为字间空列 */
+static u32 dotS_tail = 0;  /* 文字之后已送出的空列数 */
+
+/* 显示窗口：环形缓冲区，dotS_head 为最左一列 */
+static u8 dotS_win[APP_DOTS_WIDTH];
+static u32 dotS_head = 0;
+static u32 dotS_lit = 0; /* 窗口中非空列的个数 */
+
+/* 帧耗时统计（调试线程读取） */
+static app_dotS_stats_t dotS_stats = {0};
+
+static void app_dotS_timer_cb(TimerHandle_t timer)
+{
+  (void)timer;
+  (void)xEventGroupSetBits(event_bus_getHandle(), SIG_SCROLL_FRAME);
+}
+
+/**
+ * @brief 取列流的下一列
+ * @return 列数据，bit0 为最上一行
+ */
+static u8 app_dotS_next_col()
+{
+  if (dotS_text[dotS_pos] != '\0')
+  {
+    u8 c = 0;
+    if (dotS_col < APP_DOTF_WIDTH)
+      c = app_dotF_glyph(dotS_text[dotS_pos])[dotS_col];
+    if (++dotS_col > APP_DOTF_WIDTH)
+    {
+      dotS_col = 0;
+      dotS_pos++;
+    }
+    return c;
+  }
+
+  dotS_tail++;
+  return 0;
+}
+
+/**
+ * @brief 把窗口转置成各片的 8 行
+ */
+static void app_dotS_compose(u8 rows[APP_DOTS_DEVICES][8])
+{
+  u32 i = dotS_head;
+
+  for (u32 d = 0; d < APP_DOTS_DEVICES; d++)
+  {
+    u8 *out = rows[d];
+    memset(out, 0, 8);
+    for (u32 x = 0; x < 8U; x++)
+    {
+      u8 c = dotS_win[i];
+      if (++i == APP_DOTS_WIDTH)
+        i = 0;
+      for (u32 r = 0; r < APP_DOTF_HEIGHT; r++)
+        out[r] |= (u8)(((c >> r) & 1U) << x);
+    }
+  }
+}
+
+/**
+ * @brief 列流从头开始
+ */
+static void app_dotS_rewind()
+{
+  dotS_pos = 0;
+  dotS_col = 0;
+  dotS_tail = 0;
+}
+
+u32 app_dotS_step(u8 rows[APP_DOTS_DEVICES][8])
+{
+  dotS_req_t req;
+  u32 ret = 0;
+
+  if (rows == NULL)
+    return 0;
+
+  taskENTER_CRITICAL();
+  req = dotS_req;
+  dotS_req = DOTS_REQ_NONE;
+  if (req == DOTS_REQ_SHOW)
+  {
+    memcpy(dotS_text, dotS_pending, sizeof(dotS_text));
+    dotS_loops = dotS_pending_loops;
+  }
+  taskEXIT_CRITICAL();
+
+  if (req == DOTS_REQ_STOP)
+  {
+    if (dotS_running)
+      ret |= APP_DOTS_END;
+    dotS_running = false;
+    if (dotS_timer != NULL)
+      (void)xTimerStop(dotS_timer, 0);
+    return ret;
+  }
+
+  /* 新文字从全灭的窗口开始，第一帧整屏改写 */
+  if (req == DOTS_REQ_SHOW)
+  {
+    memset(dotS_win, 0, sizeof(dotS_win));
+    dotS_head = 0;
+    dotS_lit = 0;
+    dotS_rounds = 0;
+    app_dotS_rewind();
+    dotS_running = true;
+    ret |= APP_DOTS_DIRTY;
+  }
+
+  /* 停止后残留的节拍事件不渲染 */
+  if (!dotS_running)
+    return ret;
+
+  u32 c0 = DWT->CYCCNT;
+
+  /* 最左一列移出，新列从右端移入 */
+  u8 in = app_dotS_next_col();
+  u8 out = dotS_win[dotS_head];
+  if (dotS_lit != 0U || in != 0U)
+    ret |= APP_DOTS_DIRTY;
+  dotS_lit += (u32)(in != 0U) - (u32)(out != 0U);
+  dotS_win[dotS_head] = in;
+  if (++dotS_head == APP_DOTS_WIDTH)
+    dotS_head = 0;
+
+  if ((ret & APP_DOTS_DIRTY) != 0U)
+    app_dotS_compose(rows);
+
+  /* 最后一个字符完整移出，一轮结束 */
+  if (dotS_tail >= APP_DOTS_WIDTH)
+  {
+    dotS_rounds++;
+    if (dotS_loops != 0U && dotS_rounds >= dotS_loops)
+    {
+      dotS_running = false;
+      (void)xTimerStop(dotS_timer, 0);
+      ret |= APP_DOTS_END;
+    }
+    else
+      app_dotS_rewind();
+  }
+
+  u32 cycles = DWT->CYCCNT - c0;
+  taskENTER_CRITICAL();
+  dotS_stats.frames++;
+  dotS_stats.last_cycles = cycles;
+  if (cycles > dotS_stats.max_cycles)
+    dotS_stats.max_cycles = cycles;
+  taskEXIT_CRITICAL();
+
+  return ret;
+}
+
+RESULT_RUN app_dotS_show(const char *text, u8 loops)
+{
+  if (text == NULL || text[0] == '\0')
+    return ERR_RUN_ERROR_UDIP;
+  if (dotS_timer == NULL)
+    return ERR_RUN_ERROR_UNST;
+
+  taskENTER_CRITICAL();
+  strncpy(dotS_pending, text, APP_DOTS_MAX_LEN);
+  dotS_pending[APP_DOTS_MAX_LEN] = '\0';
+  dotS_pending_loops = loops;
+  dotS_req = DOTS_REQ_SHOW;
+  taskEXIT_CRITICAL();
+
+  /* 定时器未运行时 xTimerReset 会启动它 */
+  if (xTimerReset(dotS_timer, 0) != pdPASS)
+    return ERR_RUN_ERROR_CALL;
+  (void)xEventGroupSetBits(event_bus_getHandle(), SIG_SCROLL_FRAME);
+  return ERR_RUN_Finished;
+}
+
+void app_dotS_stop()
+{
+  taskENTER_CRITICAL();
+  dotS_req = DOTS_REQ_STOP;
+  taskEXIT_CRITICAL();
+  (void)xEventGroupSetBits(event_bus_getHandle(), SIG_SCROLL_FRAME);
+}
+
+bool app_dotS_active() { return dotS_running; }
+
+void app_dotS_GetStats(app_dotS_stats_t *out)
+{
+  if (out == NULL)
+    return;
+
+  taskENTER_CRITICAL();
+  *out = dotS_stats;
+  taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 调试命令：text [stop | <文字>]
+ * @note  多个参数以空格连接后滚动一轮
+ */
+static void app_dotS_cmd(int argc, char *argv[])
+{
+  app_dotS_stats_t st;
+
+  if (argc == 2 && strcmp(argv[1], "stop") == 0)
+    app_dotS_stop();
+  else if (argc >= 2)
+  {
+    char msg[APP_DOTS_MAX_LEN + 1U];
+    size_t n = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+      size_t len = strlen(argv[i]);
+      if (n != 0U && n < APP_DOTS_MAX_LEN)
+        msg[n++] = ' ';
+      if (len > APP_DOTS_MAX_LEN - n)
+        len = APP_DOTS_MAX_LEN - n;
+      memcpy(&msg[n], argv[i], len);
+      n += len;
+    }
+    msg[n] = '\0';
+
+    if (app_dotS_show(msg, 1) != ERR_RUN_Finished)
+      printf("[TEXT] show failed\r\n");
+    return;
+  }
+
+  app_dotS_GetStats(&st);
+  printf("[TEXT] %s, width=%u, col=%ums, frames=%lu\r\n",
+         dotS_running ? "scroll" : "idle", APP_DOTS_WIDTH, APP_DOTS_COL_MS,
+         (unsigned long)st.frames);
+  printf("[TEXT] cycles last=%lu, max=%lu, budget=%lu\r\n",
+         (unsigned long)st.last_cycles, (unsigned long)st.max_cycles,
+         (unsigned long)(SystemCoreClock / 1000U * APP_DOTS_COL_MS));
+}
+
+RESULT_Init app_dotS_init()
+{
+  dotS_timer = xTimerCreate("Scroll", pdMS_TO_TICKS(APP_DOTS_COL_MS), pdTRUE,
+                            NULL, app_dotS_timer_cb);
+  if (dotS_timer == NULL)
+    return ERR_Init_ERROR_RTOS;
+
+  (void)app_debug_register_cmd(DOTS_CMD_NAME, app_dotS_cmd);
+  return ERR_Init_Finished;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file		app_dot_scroll.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		点阵滚动文字
+ * @author	王广平
+ *
+ * @note
+ * 文字按 app_dot_font 的字模展开成列流（每字符 5 列加 1 列间隔），
+ * 从级联点阵的右端移入、左端移出。显示窗口是宽 APP_DOTS_WIDTH 列的环形
+ * 缓冲区，每帧只从字库取一列新列，再把窗口转置成各片的 8 行，
+ * 每帧的计算量只与点阵宽度有关，与文字长度无关。
+ * 帧节拍由一个软件定时器按 APP_DOTS_COL_MS 产生（SIG_SCROLL_FRAME），
+ * 只在滚动期间运行；显示线程收到事件后调用 app_dotS_step()。
+ * 横向按第 0 片在最左、每片行的低位在左排列，安装方向由显示线程按
+ * app_dotB_to_panel() 换算。
+ **/
+
+#ifndef __APP_DOT_SCROLL_H
+#define __APP_DOT_SCROLL_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+#include "bsp_max7219.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+// clang-format off
+
+#define APP_DOTS_DEVICES		BSP_MAX7219_CHAIN				/* 参与滚动的点阵片数 */
+#define APP_DOTS_WIDTH			(8U * APP_DOTS_DEVICES)	/* 显示宽度（列） */
+#define APP_DOTS_MAX_LEN		40U											/* 文字最大长度（字符） */
+#define APP_DOTS_COL_MS			50U											/* 每移动一列的时间 */
+
+/* app_dotS_step() 返回值 */
+#define APP_DOTS_DIRTY			(1U << 0)	/* 窗口内容有变化 */
+#define APP_DOTS_END				(1U << 7)	/* 滚动结束，窗口已全灭 */
+
+#ifdef __APP_DOT_SCROLL_C	/* 用于.c文件的宏 */
+
+#define DOTS_CMD_NAME				"text"	/* 调试命令 */
+
+#endif
+// clang-format on
+
+/* 帧耗时统计 */
+typedef struct
+{
+  u32 frames;      /* 渲染帧数 */
+  u32 last_cycles; /* 最近一帧渲染耗时（CPU 周期） */
+  u32 max_cycles;  /* 最大渲染耗时 */
+} app_dotS_stats_t;
+
+/* 函数声明 */
+
+/**
+ * @brief		初始化滚动文字模块
+ * @return	初始化结果
+ * @note		创建帧节拍定时器（不启动），注册调试命令；需在 app_anim_init()
+ *					之后调用（共用其打开的 DWT 周期计数器）
+ **/
+RESULT_Init app_dotS_init();
+
+/**
+ * @brief		开始滚动一段文字
+ * @param		text	以 '\0' 结尾的 ASCII 文字，超出 APP_DOTS_MAX_LEN 的部分截掉
+ * @param		loops	滚动轮数，0 为循环滚动直到 app_dotS_stop()
+ * @return	运行结果
+ * @note		可在任意线程调用，文字被复制；下一帧由显示线程接管点阵
+ **/
+RESULT_RUN app_dotS_show(const char *text, u8 loops);
+
+/**
+ * @brief		停止滚动
+ * @note		可在任意线程调用，下一帧返回 APP_DOTS_END
+ **/
+void app_dotS_stop();
+
+/**
+ * @brief		是否正在滚动
+ * @note		只在显示线程中调用，反映最近一次 app_dotS_step() 之后的状态
+ **/
+bool app_dotS_active();
+
+/**
+ * @brief		移动一列并合成一帧
+ * @param		rows	输出，[片][行]，逻辑方向，每片低位在左
+ * @return	APP_DOTS_DIRTY / APP_DOTS_END 的组合
+ * @note		收到 SIG_SCROLL_FRAME 时由显示线程调用；窗口不变（连续空列）
+ *					时不改写 rows，不返回 APP_DOTS_DIRTY
+ **/
+u32 app_dotS_step(u8 rows[APP_DOTS_DEVICES][8]);
+
+/**
+ * @brief		获取帧耗时统计
+ * @param		out	输出
+ **/
+void app_dotS_GetStats(app_dotS_stats_t *out);
+
+#endif
@@ -6,12 +6,19 @@
  * @date		2025/11/24
  *
  * @note（重要）
- * 1) 本模块输出的“最终用于判断逻辑的角度”是 rel（相对角度）：
- *    rel = abs_angle - zero
+ * 0) 角度全程使用整数的“百分之一度”（cdeg，1° = 100 cdeg）表示：
+ *    捕获 tick -> abs_cdeg -> rel_cdeg -> 阈值比较均不经过 float，
+ *    避免 -mfloat-abi=soft 下引入 libgcc 软浮点除法/乘法。
+ * 1) 本模块输出的“最终用于判断逻辑的角度”是 rel（相对角度，多圈）：
+ *    rel = unwrap(abs_angle) - zero
  *    - abs_angle：传感器解码出的 0~360° 绝对角度（循环）
- *    - zero：第一次得到有效角度时自动记录为 0 点
- * 2) 方向盘“转不到一圈”也可能跨越 0°/360°（例如 359°->1°），会导致直接相减出现
- *    -358° 的大跳变。因此这里对 rel 做 wrap 到 [-180, +180]。
+ *    - zero：Flash 标定的 0 点，或第一次得到有效角度时自动记录
+ * 2) 方向盘满舵约 ±1.5 圈，且“转不到一圈”也可能跨越 0°/360°（例如 359°->1°）。
+ *    因此每次捕获都把相邻读数之差按最短路径累加成连续角度（多圈展开，
+ *    见 app_gonio_core_unwrap），变化超过“最大角速度 × 捕获间隔”的读数直接丢弃；
+ *    起点按离 0 点最近的一圈对齐（假定上电时方向盘在 0 点 ±180° 内）。
+ * 3) GONIO_CAPTURE_USE_DMA=1 时，CCR1/CCR2 由 DMA 连续写入环形缓冲区，
+ *    线程逐对展开后取整个窗口连续角度的平均值。
  */
 
 #define __APP_GONIO_C
@@ -19,39 +26,480 @@
 /* 头文件引用 */
 #include "app_gonio.h"
 #include "FreeRTOS.h"
+#include "app_debug.h"
+#include "app_gonio_calib.h"
+#include "app_gonio_spi.h"
+#include "app_leds.h"
 #include "app_state.h"
+#include "bsp_dma.h"
 #include "bsp_gpio.h"
 #include "bsp_timer.h"
 #include "event_bus.h"
 #include "system_boot.h"
+#include "stm32f1xx_hal_cortex.h"
 #include "stm32f1xx_hal_gpio.h"
 #include "stm32f1xx_hal_tim.h"
 #include "task.h"
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* ============================== 静态全局变量 ============================== */
+/* 角度源（编译期选择，见 GONIO_SOURCE_SPI） */
+#if GONIO_SOURCE_SPI
+#if APP_LEDS_ENABLE
+#error "SPI 角度源与灯带都使用 DMA1_Channel5，请将 APP_LEDS_ENABLE 置 0"
+#endif
+static const app_gonio_source_t *const gonio_src = &app_gonio_source_spi;
+#else
+static const app_gonio_source_t *const gonio_src = &app_gonio_source_pwm;
+#endif
+
 /* 定时器句柄 */
 static TIM_HandleTypeDef APP_GONIO_TIM = {0};
 
-/* PWM 捕获值（单位：定时器 tick） */
-static volatile u32 pulseWidth = 0; /* 高电平宽度（CCR2） */
-static volatile u32 pwmPeriod = 0;  /* PWM 周期（CCR1） */
-static volatile oboolean_t newData = bFALSE;
+/**
+ * @brief 捕获快照（seqlock）
+ * @note
+ * 写端只有一个（中断模式为 TIM3 中断，DMA 模式为角度线程）：写前把
+ * gonio_cap_lock 加 1 变为奇数，写完再加 1 变回偶数。读端先后两次读
+ * lock，为奇数或不相等就重读，因此 {period, high, t_us, seq} 总是同一次
+ * 写入的值，全程不需要关中断。
+ */
+static volatile app_gonio_capture_t gonio_cap = {0};
+static volatile u32 gonio_cap_lock = 0;
+
+/* 线程最近取走的样本序号，与 gonio_cap.seq 不同表示有新样本 */
+static volatile u32 gonio_cap_rd_seq = 0;
+/* 丢弃的样本数（见 app_gonio_GetDropped） */
+static volatile u32 gonio_cap_dropped = 0;
 
-#define GONIO_TIM_PSC_FOR_1MHZ ((SYSTEM_BOOT_APB1_TIMER_HZ / 1000000UL) - 1UL)
+/* 最近一次捕获的时刻（中断中更新） */
+static volatile TickType_t gonio_last_edge_tick = 0;
 
 /**
- * @brief 方向盘 0 点（单位：度）
- * @note 第一次解码成功时自动记录当前 abs_angle 为 0 点。
+ * @brief 捕获时间戳（单位：us）
+ * @note TIM3 在每个上升沿被从模式复位，没有自由运行的计数值，
+ * 因此用逐周期累加 CCR1 得到连续的时间戳，32 位约 71 分钟回绕一次，
+ * 只用于求差值。只由写端更新，读端从快照的 t_us 取值。
+ * gonio_cap_clk 保存换算成 us 后剩下的定时器时钟数，不累积误差。
  */
-static float inital_value = 0;
+static u32 gonio_cap_us = 0;
+static u32 gonio_cap_clk = 0;
+
+/* 线程最近一次取得的角度对应的时间戳（单位：us），用于角速度 */
+static u32 gonio_sample_us = 0;
+/* 线程最近一次从角度源取得有效样本的时刻，用于 hold_ms 判定 */
+static TickType_t gonio_last_sample_tick = 0;
+
+/* 信号质量统计（写端与捕获快照相同；since_edge_ms 在查询时填写） */
+static app_gonio_stats_t gonio_stats = {.period_min = 0xFFFFFFFFUL,
+                                        .duty_min = 0xFFFFFFFFUL};
+static u32 gonio_stats_prev_period = 0;
+
+/* 转向判断线程句柄，用于中断中直接通知 */
+static TaskHandle_t gonio_task = NULL;
+
+#if !GONIO_CAPTURE_USE_DMA
+/* 中断抽取：捕获计数与上次通知时的高电平宽度 */
+static u32 gonio_notify_cnt = 0;
+static u32 gonio_notify_high = 0;
+/* 上次唤醒线程时的样本序号，用于判断线程是否来不及取走 */
+static u32 gonio_cap_wake_seq = 0;
+#endif
+
+#if GONIO_CAPTURE_USE_DMA
+#define GONIO_DMA_RING_LEN (GONIO_DMA_RING_PAIRS * 2UL)
+
+/* DMA 句柄 */
+static DMA_HandleTypeDef APP_GONIO_DMA = {0};
+
+/* DMA 环形缓冲区：按 {CCR1, CCR2} 成对排列（单位：定时器 tick） */
+static u16 gonio_dma_ring[GONIO_DMA_RING_LEN];
+/* 线程侧读指针（单位：半字，始终为偶数） */
+static u32 gonio_dma_rd = 0;
+/* 半传输/传输完成中断计数，以及线程上次读取时的值，用于检测环形缓冲区被追上 */
+static volatile u32 gonio_dma_halves = 0;
+static u32 gonio_dma_halves_seen = 0;
+#endif
+
+/**
+ * @brief 由标称 PWM 频率推导的定时器参数
+ * @note GONIO_TIM_DIV 为预分频系数（PSC + 1），取使标称周期计数值
+ * 不超过 GONIO_PWM_FILL_TICKS 的最小值。
+ */
+#define GONIO_TIM_DIV                                                         \
+  ((SYSTEM_BOOT_APB1_TIMER_HZ / GONIO_PWM_EXPECT_HZ + GONIO_PWM_FILL_TICKS -  \
+    1UL) /                                                                    \
+   GONIO_PWM_FILL_TICKS)
+#define GONIO_TIM_HZ (SYSTEM_BOOT_APB1_TIMER_HZ / GONIO_TIM_DIV)
+#define GONIO_TIM_CLK_PER_US (SYSTEM_BOOT_APB1_TIMER_HZ / 1000000UL)
+#define GONIO_NOTIFY_DEADBAND_TICKS                                           \
+  (GONIO_NOTIFY_DEADBAND_US * GONIO_TIM_HZ / 1000000UL)
+/* 周期允许的最大溢出次数，超过按无效周期处理 */
+#define GONIO_PWM_OVF_MAX ((GONIO_TIM_HZ / GONIO_PWM_MIN_HZ) >> 16)
+
+#if GONIO_TIM_DIV > 0x10000UL
+#error "GONIO_PWM_EXPECT_HZ 过低，预分频超出 16 位"
+#endif
+
+#if GONIO_CAPTURE_USE_DMA
+#undef GONIO_PWM_EXTEND
+#define GONIO_PWM_EXTEND 0
+#endif
+
+#if GONIO_PWM_EXTEND
+/**
+ * @brief 软件溢出计数（只在 TIM3 中断中访问）
+ * @note
+ * - gonio_ovf：自最近一次上升沿（计数器被从模式复位）以来的溢出次数。
+ *   上升沿中断里发现本次复位之前还有一个溢出挂起时置为 -1，
+ *   稍后该溢出的更新中断把它加回 0
+ * - gonio_ovf_period：CCR1 当前保存的那个周期内的溢出次数
+ */
+static s32 gonio_ovf = 0;
+static u32 gonio_ovf_period = 0;
+#endif
+
+/**
+ * @brief 方向盘 0 点（单位：cdeg）
+ * @note 启动时从 Flash 标定记录加载；没有有效记录时，
+ * 第一次解码成功时自动记录当前 abs_cdeg 为 0 点（不保存）。
+ */
+static s32 inital_value = 0;
 static oboolean_t zero_inited = bFALSE;
 
 /**
- * @brief 将角度差限制到 [-180, +180]（单位：度）
- * @note 只要传感器角度存在 0°/360° 回绕，就建议做这个处理。
+ * @brief 标定相关的运行时状态
+ * @note
+ * - gonio_decode_low：解码极性，默认取 GONIO_PWM_DECODE_USE_LOW_TIME
+ * - gonio_last_abs：最近一次有效绝对角度，供 "gonio zero" 使用，-1 表示还没有
+ * - gonio_last_acc：最近一次样本的多圈累加值，供 "gonio show" 显示圈数
+ * - gonio_calib_changed：调试线程修改了 0 点/极性，角度线程下次取样时清空滤波器
+ */
+static volatile bool gonio_decode_low = GONIO_PWM_DECODE_USE_LOW_TIME;
+static volatile s32 gonio_last_abs = -1;
+static volatile s32 gonio_last_acc = 0;
+static volatile bool gonio_calib_changed = false;
+
+/**
+ * @brief 转向判定参数
+ * @note 调试线程在临界区内整体替换并递增 gonio_param_ver，
+ * 角度线程发现版本变化时才复制一份到本地，平时不进临界区。
+ */
+static app_gonio_param_t gonio_param = {
+    .turn_on_cdeg = GONIO_TURN_ON_CDEG,
+    .center_cdeg = GONIO_CENTER_CDEG,
+    .hyst_cdeg = GONIO_HYST_CDEG,
+    .turn_ms = GONIO_TURN_MS,
+    .center_ms = GONIO_CENTER_MS,
+    .hold_ms = GONIO_HOLD_MS,
+    .predict_ms = GONIO_PREDICT_STABLE_MS,
+    .confirm_ms = GONIO_PREDICT_CONFIRM_MS,
+};
+static volatile u32 gonio_param_ver = 1;
+
+/* 硬件无关核心：滤波、角速度与转向状态机（只在角度线程中使用） */
+static app_gonio_core_t gonio_core;
+
+/**
+ * @brief tick 换算成 ms（核心按 ms 计时，只用于求差值）
  */
-static inline float app_gonio_wrap_deg_180(float delta_deg)
+static inline u32 app_gonio_tick_ms(TickType_t tick)
+{
+  return (u32)tick * (u32)portTICK_PERIOD_MS;
+}
+
+/**
+ * @brief 多圈展开状态（写端与捕获快照相同）
+ * @note
+ * - gonio_unwrap_low：展开时使用的解码极性，极性变化后读数整体镜像，需要重新展开
+ * - gonio_unwrap_req/ack：调试线程重设 0 点时递增 req，写端发现与 ack 不等时
+ *   以当前读数为起点重新展开，避免已累加的整圈数叠加到新的 0 点上
+ */
+static app_gonio_unwrap_t gonio_unwrap = {.prev_abs = -1};
+static bool gonio_unwrap_low = GONIO_PWM_DECODE_USE_LOW_TIME;
+static volatile u32 gonio_unwrap_req = 0;
+static u32 gonio_unwrap_ack = 0;
+
+/**
+ * @brief 按一次捕获的周期推进时间戳（只能由捕获快照的写端调用）
+ */
+static inline void app_gonio_cap_advance(u32 period)
+{
+  gonio_cap_clk += period * GONIO_TIM_DIV;
+  gonio_cap_us += gonio_cap_clk / GONIO_TIM_CLK_PER_US;
+  gonio_cap_clk %= GONIO_TIM_CLK_PER_US;
+}
+
+/**
+ * @brief 解码并展开一次捕获（只能由捕获快照的写端调用，须先 app_gonio_cap_advance）
+ * @return 被接受的绝对角度，-1 表示无效或被拒绝
+ */
+static inline s32 app_gonio_cap_unwrap(u32 period, u32 high)
+{
+  bool low = gonio_decode_low;
+  u32 req = gonio_unwrap_req;
+
+  if (low != gonio_unwrap_low || req != gonio_unwrap_ack)
+  {
+    gonio_unwrap_low = low;
+    gonio_unwrap_ack = req;
+    app_gonio_core_unwrap_init(&gonio_unwrap);
+  }
+
+  s32 abs_cdeg = app_gonio_core_decode(period, high, low);
+  return app_gonio_core_unwrap(&gonio_unwrap, abs_cdeg, gonio_cap_us) ? abs_cdeg
+                                                                     : -1;
+}
+
+/**
+ * @brief 发布一次捕获快照（只能由唯一的写端调用）
+ */
+static inline void app_gonio_cap_publish(u32 period, u32 high, u32 t_us,
+                                         s32 abs_cdeg)
+{
+  u32 seq = gonio_cap.seq + 1U;
+  if (seq == 0U)
+    seq = 1U; /* 0 保留给“还没有样本” */
+
+  gonio_cap_lock++;
+  __DMB();
+  gonio_cap.period = period;
+  gonio_cap.high = high;
+  gonio_cap.t_us = t_us;
+  gonio_cap.seq = seq;
+  gonio_cap.abs_cdeg = abs_cdeg;
+  gonio_cap.unwrap_base = gonio_unwrap.base_abs;
+  gonio_cap.unwrap_acc = gonio_unwrap.acc;
+  __DMB();
+  gonio_cap_lock++;
+}
+
+/**
+ * @brief 读取一次一致的捕获快照
+ */
+static inline void app_gonio_cap_read(app_gonio_capture_t *out)
+{
+  u32 s1 = 0;
+  u32 s2 = 0;
+
+  do
+  {
+    s1 = gonio_cap_lock;
+    __DMB();
+    out->period = gonio_cap.period;
+    out->high = gonio_cap.high;
+    out->t_us = gonio_cap.t_us;
+    out->seq = gonio_cap.seq;
+    out->abs_cdeg = gonio_cap.abs_cdeg;
+    out->unwrap_base = gonio_cap.unwrap_base;
+    out->unwrap_acc = gonio_cap.unwrap_acc;
+    __DMB();
+    s2 = gonio_cap_lock;
+  } while ((s1 & 1U) != 0U || s1 != s2);
+}
+
+/**
+ * @brief 统计一次捕获（只能由捕获快照的写端调用）
+ * @note 只有比较、计数和一次硬件除法，适合放在中断里
+ */
+static inline void app_gonio_stats_capture(u32 period, u32 high)
+{
+  if (period == 0U)
+  {
+    gonio_stats.rej_period++;
+    return;
+  }
+  if (high == 0U || high >= period)
+  {
+    gonio_stats.rej_high++;
+    return;
+  }
+
+  gonio_stats.valid++;
+  if (period < gonio_stats.period_min)
+    gonio_stats.period_min = period;
+  if (period > gonio_stats.period_max)
+    gonio_stats.period_max = period;
+
+  /* 溢出扩展后的长周期先同时缩小，避免乘法溢出 */
+  u32 p = period;
+  u32 h = high;
+  while (p > 0xFFFFUL)
+  {
+    p >>= 1;
+    h >>= 1;
+  }
+  u32 duty = (h * 10000UL) / p;
+  if (duty < gonio_stats.duty_min)
+    gonio_stats.duty_min = duty;
+  if (duty > gonio_stats.duty_max)
+    gonio_stats.duty_max = duty;
+
+  /* 抖动按 |Δperiod| 的二进制位数分桶：0 -> 0，1 -> 1，2~3 -> 2 … */
+  if (gonio_stats_prev_period != 0U)
+  {
+    u32 d = (period > gonio_stats_prev_period)
+                ? (period - gonio_stats_prev_period)
+                : (gonio_stats_prev_period - period);
+    u32 bin = 32U - __CLZ(d);
+    if (bin >= GONIO_STATS_JITTER_BINS)
+      bin = GONIO_STATS_JITTER_BINS - 1U;
+    gonio_stats.jitter_hist[bin]++;
+  }
+  gonio_stats_prev_period = period;
+}
+
+#if GONIO_CAPTURE_USE_DMA
+/**
+ * @brief 计算 DMA 当前写指针（单位：半字）
+ * @note 一次突发写两个半字，CNDTR 可能停在突发中间，因此向下取整到偶数，
+ * 只把完整的 {CCR1, CCR2} 对交给线程。
+ */
+static inline u32 app_gonio_dma_wr(void)
+{
+  u32 wr = (GONIO_DMA_RING_LEN - __HAL_DMA_GET_COUNTER(&APP_GONIO_DMA)) & ~1UL;
+  return (wr >= GONIO_DMA_RING_LEN) ? 0 : wr;
+}
+
+/**
+ * @brief 取出自上次读取以来的全部捕获对，逐对展开后求窗口平均
+ * @param unwrap_acc 输出窗口内多圈累加值的平均
+ * @retval 窗口内最后一个被接受的绝对角度，-1 表示窗口内没有有效样本
+ */
+static s32 app_gonio_dma_window_abs(s32 *unwrap_acc)
+{
+  u32 wr = app_gonio_dma_wr();
+  u32 halves = gonio_dma_halves;
+  u32 period = 0;
+  u32 high = 0;
+  s32 last = -1;
+  s32 a = -1;
+  s32 sum = 0;
+  s32 n = 0;
+
+  /**
+   * @note 两次读取之间经过了 3 个及以上半缓冲区，说明写端至少追上读端一次：
+   * 未读的数据已被覆盖，按整半缓冲区计入丢弃并直接从写指针处重新开始。
+   */
+  u32 passed = halves - gonio_dma_halves_seen;
+  gonio_dma_halves_seen = halves;
+  if (passed > 2U)
+  {
+    gonio_cap_dropped += (passed - 2U) * (GONIO_DMA_RING_PAIRS / 2U);
+    gonio_dma_rd = wr;
+  }
+
+  while (gonio_dma_rd != wr)
+  {
+    period = gonio_dma_ring[gonio_dma_rd];
+    high = gonio_dma_ring[gonio_dma_rd + 1];
+    gonio_dma_rd = (gonio_dma_rd + 2) % GONIO_DMA_RING_LEN;
+    app_gonio_cap_advance(period);
+    app_gonio_stats_capture(period, high);
+
+    a = app_gonio_cap_unwrap(period, high);
+    if (a < 0)
+      continue;
+
+    /* 展开后的累加值是连续的，直接求平均即可，不用担心跨越 0°/360° */
+    last = a;
+    sum += gonio_unwrap.acc;
+    n++;
+  }
+
+  /* 发布窗口内最后一对原始值，供快照接口与调试打印 */
+  if (period != 0U)
+  {
+    app_gonio_cap_publish(period, high, gonio_cap_us, a);
+    gonio_cap_rd_seq = gonio_cap.seq;
+  }
+
+  if (n == 0)
+    return -1;
+  gonio_last_edge_tick = xTaskGetTickCount();
+
+  *unwrap_acc = sum / n;
+  return last;
+}
+#endif
+
+/**
+ * @brief 是否有尚未被线程取走的捕获数据
+ */
+static bool app_gonio_pwm_pending(void)
+{
+#if GONIO_CAPTURE_USE_DMA
+  return gonio_dma_rd != app_gonio_dma_wr();
+#else
+  return gonio_cap.seq != gonio_cap_rd_seq;
+#endif
+}
+
+/**
+ * @brief 取出新样本（PWM 角度源）
+ */
+static bool app_gonio_pwm_read(app_gonio_sample_t *out)
+{
+#if GONIO_CAPTURE_USE_DMA
+  out->unwrap_acc = 0;
+  out->abs_cdeg = app_gonio_dma_window_abs(&out->unwrap_acc);
+  out->unwrap_base = gonio_unwrap.base_abs;
+  out->t_us = gonio_cap_us;
+#else
+  app_gonio_capture_t cap;
+  app_gonio_cap_read(&cap);
+  if (cap.seq == gonio_cap_rd_seq)
+    return false;
+  gonio_cap_rd_seq = cap.seq;
+
+  out->abs_cdeg = cap.abs_cdeg;
+  out->unwrap_base = cap.unwrap_base;
+  out->unwrap_acc = cap.unwrap_acc;
+  out->t_us = cap.t_us;
+#endif
+  return out->abs_cdeg >= 0;
+}
+
+/**
+ * @brief 重新开始多圈展开（PWM 角度源）
+ * @note 极性由写端直接读 gonio_decode_low，这里只需通知写端
+ */
+static void app_gonio_pwm_resync(bool invert)
+{
+  (void)invert;
+  gonio_unwrap_req++;
+}
+
+/**
+ * @brief 打印捕获计数（PWM 角度源）
+ */
+static void app_gonio_pwm_show(void)
+{
+  printf("[GONIO] seq=%lu, dropped=%lu, unwrap_rej=%lu, tick=%luHz\r\n",
+         (unsigned long)gonio_cap.seq, (unsigned long)gonio_cap_dropped,
+         (unsigned long)gonio_unwrap.rejects, (unsigned long)GONIO_TIM_HZ);
+}
+
+#if GONIO_BENCH_DECODE
+/**
+ * @brief 旧的软浮点解码路径，仅用于与整数路径对比周期数
+ */
+static float app_gonio_decode_abs_float(u32 period, u32 high)
+{
+  if (period == 0 || high == 0 || high >= period)
+    return -1;
+
+  float duty = (float)high / (float)period;
+  float abs_angle = gonio_decode_low ? (1.0f - duty) * 360.0f : duty * 360.0f;
+  if (abs_angle >= 360.0f)
+    abs_angle = 0;
+  return abs_angle;
+}
+
+static float app_gonio_wrap_deg_180_float(float delta_deg)
 {
   while (delta_deg > 180.0f)
     delta_deg -= 360.0f;
@@ -60,8 +508,261 @@ static inline float app_gonio_wrap_deg_180(float delta_deg)
   return delta_deg;
 }
 
+/**
+ * @brief 用 DWT 周期计数器对比 float 与 cdeg 两条解码路径（解码 + wrap + 阈值），
+ * 并测量滤波级与状态机每个样本的代价
+ * @note 仅在 GONIO_BENCH_DECODE=1 时编译，结果通过串口打印；
+ * 使用独立的核心实例，不影响正在运行的状态。
+ */
+static void app_gonio_bench_decode(void)
+{
+  static app_gonio_core_t bench;
+  app_gonio_param_t p;
+  volatile u32 sink = 0;
+  u32 i = 0;
+
+  app_gonio_core_init(&bench);
+  app_gonio_GetParam(&p);
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  u32 t0 = DWT->CYCCNT;
+  for (i = 0; i < GONIO_BENCH_LOOPS; i++)
+  {
+    float rel = app_gonio_wrap_deg_180_float(
+        app_gonio_decode_abs_float(1000U, 10U + (i % 980U)) - 123.45f);
+    sink += (rel >= 90.0f) ? 1U : ((rel <= -90.0f) ? 2U : 0U);
+  }
+  u32 t1 = DWT->CYCCNT;
+  for (i = 0; i < GONIO_BENCH_LOOPS; i++)
+  {
+    s32 rel = app_gonio_core_wrap_180(
+        app_gonio_core_decode(1000U, 10U + (i % 980U), false) - 12345);
+    sink += (rel >= 9000) ? 1U : ((rel <= -9000) ? 2U : 0U);
+  }
+  u32 t2 = DWT->CYCCNT;
+  for (i = 0; i < GONIO_BENCH_LOOPS; i++)
+  {
+    /* 每 16 个样本注入一个 ±170° 的毛刺 */
+    s32 x = (s32)(i % 9000U) + (((i & 15U) == 0U) ? 17000 : 0);
+    sink += (u32)app_gonio_core_filter(&bench, x);
+  }
+  u32 t3 = DWT->CYCCNT;
+  for (i = 0; i < GONIO_BENCH_LOOPS; i++)
+  {
+    /* 1ms 一个样本，在 ±120° 之间往复，覆盖转向与回正 */
+    s32 x = (s32)(i % 480U) * 50 - 12000;
+    app_gonio_core_velocity(&bench, x, i * 1000U);
+    sink += app_gonio_core_step(&bench, &p, x, i) ? 1U : 0U;
+  }
+  u32 t4 = DWT->CYCCNT;
+
+  printf("[GONIO] bench float=%lu cyc/sample, cdeg=%lu cyc/sample, "
+         "filter=%lu cyc/sample, step=%lu cyc/sample\r\n",
+         (unsigned long)((t1 - t0) / GONIO_BENCH_LOOPS),
+         (unsigned long)((t2 - t1) / GONIO_BENCH_LOOPS),
+         (unsigned long)((t3 - t2) / GONIO_BENCH_LOOPS),
+         (unsigned long)((t4 - t3) / GONIO_BENCH_LOOPS));
+  (void)sink;
+}
+#endif
+
+/* ============================== 标定命令 ============================== */
+
+/**
+ * @brief 打印带符号的 cdeg 值（xx.xx）
+ */
+static void app_gonio_print_cdeg(const char *tag, s32 cdeg)
+{
+  s32 mag = (cdeg < 0) ? -cdeg : cdeg;
+  printf("%s=%s%ld.%02ld", tag, (cdeg < 0) ? "-" : "", (long)(mag / 100),
+         (long)(mag % 100));
+}
+
+/**
+ * @brief 保存当前 0 点、极性与转向判定参数到 Flash
+ */
+static void app_gonio_calib_commit(void)
+{
+  app_gonio_calib_t cal;
+
+  taskENTER_CRITICAL();
+  cal.zero_cdeg = inital_value;
+  cal.decode_low = gonio_decode_low;
+  cal.param = gonio_param;
+  taskEXIT_CRITICAL();
+
+  RESULT_RUN ret = app_gonio_calib_save(&cal);
+  printf("[GONIO] calib save: ");
+  ERR_ShowBy_USART_RUN(ret);
+}
+
+/**
+ * @brief 调试命令 "gonio"
+ * @note
+ * - gonio show：打印 0 点、极性、当前绝对角度、样本序号与丢弃数
+ * - gonio stats [clr]：打印（或清零）PWM 信号质量统计
+ * - gonio zero：把当前方向盘位置设为 0 点并保存
+ * - gonio pol 0|1：设置解码极性（1=低电平宽度）并保存，0 点随之镜像，
+ *   方向盘物理 0 点不变
+ * - gonio param：打印转向判定参数
+ * - gonio param <名称> <值>：修改单个参数，立即生效但不保存
+ * - gonio param save | def：保存到 Flash / 恢复默认值
+ */
+static void app_gonio_cmd_param(int argc, char *argv[])
+{
+  static const struct
+  {
+    const char *name;
+    u32 offset;
+  } fields[] = {
+      {"on", offsetof(app_gonio_param_t, turn_on_cdeg)},
+      {"center", offsetof(app_gonio_param_t, center_cdeg)},
+      {"hyst", offsetof(app_gonio_param_t, hyst_cdeg)},
+      {"turn_ms", offsetof(app_gonio_param_t, turn_ms)},
+      {"center_ms", offsetof(app_gonio_param_t, center_ms)},
+      {"hold_ms", offsetof(app_gonio_param_t, hold_ms)},
+      {"pred_ms", offsetof(app_gonio_param_t, predict_ms)},
+      {"confirm_ms", offsetof(app_gonio_param_t, confirm_ms)},
+  };
+  app_gonio_param_t p;
+  u32 i = 0;
+
+  app_gonio_GetParam(&p);
+
+  if (argc == 3 && strcmp(argv[2], "save") == 0)
+  {
+    app_gonio_calib_commit();
+    return;
+  }
+  if (argc == 3 && strcmp(argv[2], "def") == 0)
+  {
+    p.turn_on_cdeg = GONIO_TURN_ON_CDEG;
+    p.center_cdeg = GONIO_CENTER_CDEG;
+    p.hyst_cdeg = GONIO_HYST_CDEG;
+    p.turn_ms = GONIO_TURN_MS;
+    p.center_ms = GONIO_CENTER_MS;
+    p.hold_ms = GONIO_HOLD_MS;
+    p.predict_ms = GONIO_PREDICT_STABLE_MS;
+    p.confirm_ms = GONIO_PREDICT_CONFIRM_MS;
+    (void)app_gonio_SetParam(&p);
+    return;
+  }
+  if (argc == 4)
+  {
+    char *end = NULL;
+    long v = strtol(argv[3], &end, 10);
+
+    for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+      if (strcmp(argv[2], fields[i].name) == 0)
+        break;
+    }
+    if (i == sizeof(fields) / sizeof(fields[0]) || end == argv[3] ||
+        *end != '\0')
+    {
+      printf("[GONIO] bad param\r\n");
+      return;
+    }
+    /* 各字段都是 32 位，按 s32 写入；负数写进 u32 字段会被范围检查拒绝 */
+    *(s32 *)((u8 *)&p + fields[i].offset) = (s32)v;
+    printf("[GONIO] set %s: ", fields[i].name);
+    ERR_ShowBy_USART_RUN(app_gonio_SetParam(&p));
+    return;
+  }
+
+  printf("[GONIO]");
+  for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    printf(" %s=%ld", fields[i].name,
+           (long)*(const s32 *)((const u8 *)&p + fields[i].offset));
+  printf("\r\n");
+}
+
+static void app_gonio_cmd(int argc, char *argv[])
+{
+  if (argc >= 2 && strcmp(argv[1], "zero") == 0)
+  {
+    s32 abs_cdeg = gonio_last_abs;
+    if (abs_cdeg < 0)
+    {
+      printf("[GONIO] no valid angle, zero not set\r\n");
+      return;
+    }
+    taskENTER_CRITICAL();
+    inital_value = abs_cdeg;
+    zero_inited = bTRUE;
+    gonio_calib_changed = true;
+    taskEXIT_CRITICAL();
+    gonio_src->resync(gonio_decode_low);
+    app_gonio_calib_commit();
+  }
+  else if (argc >= 3 && strcmp(argv[1], "pol") == 0 &&
+           (strcmp(argv[2], "0") == 0 || strcmp(argv[2], "1") == 0))
+  {
+    bool low = (argv[2][0] == '1');
+    taskENTER_CRITICAL();
+    if (low != gonio_decode_low)
+    {
+      gonio_decode_low = low;
+      inital_value = (GONIO_CDEG_360 - inital_value) % GONIO_CDEG_360;
+      gonio_calib_changed = true;
+    }
+    taskEXIT_CRITICAL();
+    gonio_src->resync(low);
+    app_gonio_calib_commit();
+  }
+  else if (argc >= 2 && strcmp(argv[1], "show") == 0)
+  {
+    printf("[GONIO] src=%s, ", gonio_src->name);
+    app_gonio_print_cdeg("zero", inital_value);
+    printf(", pol=%u, ", gonio_decode_low ? 1U : 0U);
+    if (gonio_last_abs < 0)
+      printf("abs=--");
+    else
+      app_gonio_print_cdeg("abs", gonio_last_abs);
+    printf(", turns=%ld\r\n", (long)(gonio_last_acc / GONIO_CDEG_360));
+    gonio_src->show();
+  }
+  else if (argc >= 2 && strcmp(argv[1], "stats") == 0)
+  {
+    if (argc >= 3 && strcmp(argv[2], "clr") == 0)
+    {
+      app_gonio_ResetStats();
+      return;
+    }
+
+    app_gonio_stats_t st;
+    u32 i = 0;
+    app_gonio_GetStats(&st);
+    printf("[GONIO] valid=%lu, rej_period=%lu, rej_high=%lu, "
+           "period=%lu~%lu@%luHz, duty=%lu~%lu/10000, since_edge=%lums\r\n",
+           (unsigned long)st.valid, (unsigned long)st.rej_period,
+           (unsigned long)st.rej_high, (unsigned long)st.period_min,
+           (unsigned long)st.period_max, (unsigned long)GONIO_TIM_HZ, (unsigned long)st.duty_min,
+           (unsigned long)st.duty_max, (unsigned long)st.since_edge_ms);
+    printf("[GONIO] jitter:");
+    for (i = 0; i < GONIO_STATS_JITTER_BINS; i++)
+      printf(" %lu", (unsigned long)st.jitter_hist[i]);
+    printf("\r\n");
+  }
+  else if (argc >= 2 && strcmp(argv[1], "param") == 0)
+  {
+    app_gonio_cmd_param(argc, argv);
+  }
+  else
+  {
+    printf("usage: gonio show | zero | pol 0|1 | stats [clr] | "
+           "param [save|def|<name> <val>]\r\n");
+  }
+}
+
 /* ============================== 初始化与驱动 ============================== */
-RESULT_Init app_gonio_init()
+/**
+ * @brief PWM 角度源初始化：TIM3 输入捕获（中断或 DMA）
+ */
+static RESULT_Init app_gonio_pwm_init(void)
 {
   RESULT_Init ret = ERR_Init_Start;
 
@@ -69,8 +770,8 @@ RESULT_Init app_gonio_init()
   bsp_gpio_Init(GONIO_GPIOx, GONIO_PIN, GPIO_MODE_AF_INPUT, GPIO_NOPULL,
                 GPIO_SPEED_FREQ_HIGH);
 
-  /* 初始化 TIM3：72MHz/72 = 1MHz（1 tick = 1us） */
-  bsp_timer_SetStruct(&APP_GONIO_TIM, GONIO_TIMx, GONIO_TIM_PSC_FOR_1MHZ,
+  /* 初始化 TIM3：预分频由标称 PWM 频率自动选择（1kHz 时 72MHz/2 = 36MHz） */
+  bsp_timer_SetStruct(&APP_GONIO_TIM, GONIO_TIMx, GONIO_TIM_DIV - 1UL,
                       TIM_COUNTERMODE_UP, 0xFFFF, TIM_CLOCKDIVISION_DIV1,
                       TIM_AUTORELOAD_PRELOAD_DISABLE, 0);
 
@@ -109,96 +810,256 @@ RESULT_Init app_gonio_init()
   if (HAL_TIM_SlaveConfigSynchro(&APP_GONIO_TIM, &sSlaveConfig) != HAL_OK)
     return ERR_Init_ERROR_TIM;
 
-  /* 使能 TIM3 中断 */
-  HAL_NVIC_SetPriority(TIM3_IRQn, 2, 0);
+#if GONIO_CAPTURE_USE_DMA
+  /**
+   * @brief DMA 突发读取
+   * @note F103 上 TIM3_CH2 没有 DMA 请求，因此由 CC1（上升沿）请求触发，
+   * 通过 DMAR 一次读出 CCR1、CCR2 两个寄存器：
+   * - CCR1：刚结束的周期
+   * - CCR2：同一周期内的高电平宽度
+   * 每个捕获沿不产生中断，只在半传输/传输完成时进入 DMA 中断通知线程。
+   */
+  DMA_Init_Config dma_cfg = bsp_dma_conf_PWM(GONIO_DMA_CHANNEL);
+  if (bsp_dma_init(&APP_GONIO_DMA, &dma_cfg) != ERR_Init_Finished)
+    return ERR_Init_ERROR_DMA;
+  __HAL_LINKDMA(&APP_GONIO_TIM, hdma[TIM_DMA_ID_CC1], APP_GONIO_DMA);
+
+  if (HAL_TIM_IC_Start(&APP_GONIO_TIM, TIM_CHANNEL_1) != HAL_OK)
+    return ERR_Init_ERROR_TIM;
+  if (HAL_TIM_IC_Start(&APP_GONIO_TIM, TIM_CHANNEL_2) != HAL_OK)
+    return ERR_Init_ERROR_TIM;
+  if (HAL_TIM_DMABurst_MultiReadStart(
+          &APP_GONIO_TIM, TIM_DMABASE_CCR1, TIM_DMA_CC1,
+          (uint32_t *)gonio_dma_ring, TIM_DMABURSTLENGTH_2TRANSFERS,
+          GONIO_DMA_RING_LEN) != HAL_OK)
+    return ERR_Init_ERROR_DMA;
+
+  HAL_NVIC_SetPriority(GONIO_DMA_IRQn, GONIO_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(GONIO_DMA_IRQn);
+#else
+  /* 使能 TIM3 中断（优先级需不高于 configMAX_SYSCALL_INTERRUPT_PRIORITY） */
+  HAL_NVIC_SetPriority(TIM3_IRQn, GONIO_IRQ_PRIORITY, 0);
   HAL_NVIC_EnableIRQ(TIM3_IRQn);
 
-  /* 开始输入捕获中断 */
+#if GONIO_PWM_EXTEND
+  /**
+   * @note 溢出扩展：
+   * - URS=1：从模式复位不再产生更新事件，UIF 只表示计数溢出；
+   *   HAL_TIM_IC_Init 里软件产生的更新事件留下的 UIF 要先清掉
+   * - CC1 中断记录每个周期的溢出次数，CH2 中断按同样方式扩展高电平宽度
+   */
+  __HAL_TIM_URS_ENABLE(&APP_GONIO_TIM);
+  __HAL_TIM_CLEAR_FLAG(&APP_GONIO_TIM, TIM_FLAG_UPDATE);
+  __HAL_TIM_ENABLE_IT(&APP_GONIO_TIM, TIM_IT_UPDATE);
   if (HAL_TIM_IC_Start_IT(&APP_GONIO_TIM, TIM_CHANNEL_1) != HAL_OK)
     return ERR_Init_ERROR_TIM;
+#else
+  /**
+   * @note 只开 CH2（下降沿）中断，在同一次中断里读出 CCR1/CCR2：
+   * CCR1 在本周期上升沿锁存，不会与另一次中断写入的值拼接，中断次数也减半。
+   */
+  if (HAL_TIM_IC_Start(&APP_GONIO_TIM, TIM_CHANNEL_1) != HAL_OK)
+    return ERR_Init_ERROR_TIM;
+#endif
   if (HAL_TIM_IC_Start_IT(&APP_GONIO_TIM, TIM_CHANNEL_2) != HAL_OK)
     return ERR_Init_ERROR_TIM;
+#endif
 
   ret = ERR_Init_Finished;
   return ret;
 }
 
+const app_gonio_source_t app_gonio_source_pwm = {
+    .name = "pwm",
+    .hint = "未捕获到PWM输入，请检查：PA6(TIM3_CH1)接线/供电/磁铁距离/定时器中断",
+    .init = app_gonio_pwm_init,
+    .read = app_gonio_pwm_read,
+    .pending = app_gonio_pwm_pending,
+    .resync = app_gonio_pwm_resync,
+    .show = app_gonio_pwm_show,
+};
+
+RESULT_Init app_gonio_init()
+{
+  app_gonio_core_init(&gonio_core);
+
+  /* 加载 Flash 标定：存在有效记录时直接使用，不再自动校零 */
+  app_gonio_calib_t cal;
+  if (app_gonio_calib_load(&cal))
+  {
+    inital_value = cal.zero_cdeg;
+    gonio_decode_low = cal.decode_low;
+    zero_inited = bTRUE;
+    /* 记录中的参数不合理时保留默认值 */
+    (void)app_gonio_SetParam(&cal.param);
+  }
+  (void)app_debug_register_cmd("gonio", app_gonio_cmd);
+
+  gonio_src->resync(gonio_decode_low);
+  return gonio_src->init();
+}
+
 /**
  * @brief 获取当前相对角度（最终用于判断逻辑的值）
- * @retval -1 表示暂无新数据或本次数据无效
+ * @param out_cdeg 输出相对角度（单位：cdeg）
+ * @return false 表示暂无新数据或本次数据无效
  */
-float app_gonio_GetAngleDeg(void)
+bool app_gonio_GetAngleCdeg(s32 *out_cdeg)
 {
-  if (!newData)
-    return -1;
-  newData = bFALSE;
-
-  /* 过滤明显无效的捕获：period==0 / high==0 / high>=period */
-  if (pwmPeriod == 0 || pulseWidth == 0 || pulseWidth >= pwmPeriod)
-    return -1;
+  if (out_cdeg == NULL)
+    return false;
 
-  float duty = (float)pulseWidth / (float)pwmPeriod;
-  if (duty < 0)
-    duty = 0;
-  if (duty > 1.0f)
-    duty = 1.0f;
-
-  /* 绝对角度（0~360 循环） */
-#if GONIO_PWM_DECODE_USE_LOW_TIME
-  float abs_angle = (1.0f - duty) * 360.0f;
-#else
-  float abs_angle = duty * 360.0f;
-#endif
+  app_gonio_sample_t s;
+  if (!gonio_src->read(&s))
+    return false;
+  s32 abs_angle = s.abs_cdeg;
+  gonio_sample_us = s.t_us;
+  gonio_last_sample_tick = xTaskGetTickCount();
+  gonio_last_abs = abs_angle;
+  gonio_last_acc = s.unwrap_acc;
 
-  /* 规范化到 [0, 360) */
-  if (abs_angle < 0)
-    abs_angle = 0;
-  if (abs_angle >= 360.0f)
-    abs_angle = 0;
+  /* 调试线程修改了 0 点/极性：旧的滤波历史不再连续 */
+  if (gonio_calib_changed)
+  {
+    gonio_calib_changed = false;
+    app_gonio_core_reset(&gonio_core);
+  }
 
   /**
    * @note 自动校零：第一次有效角度作为 0 点
-   * - 这一帧返回 -1，避免初始化瞬间误触发转向/回正事件
+   * - 这一帧返回 false，避免初始化瞬间误触发转向/回正事件
    */
   if (!zero_inited)
   {
     zero_inited = bTRUE;
     inital_value = abs_angle;
-    return -1;
+    return false;
   }
 
-  /* 相对角度：wrap 到 [-180, +180] */
-  return app_gonio_wrap_deg_180(abs_angle - inital_value);
+  /* 相对角度：多圈展开后相对 0 点的角度，再经过滤波 */
+  *out_cdeg = app_gonio_core_filter(
+      &gonio_core,
+      app_gonio_core_unwrap_rel(s.unwrap_base, s.unwrap_acc, inital_value));
+  return true;
+}
+
+void app_gonio_NotifyFromISR(void)
+{
+  BaseType_t woken = pdFALSE;
+
+  if (gonio_task == NULL)
+    return;
+  vTaskNotifyGiveFromISR(gonio_task, &woken);
+  portYIELD_FROM_ISR(woken);
 }
 
 /**
  * @brief 输入捕获中断回调转发（由 stm32f1xx_it.c 调用）
+ * @note
+ * - 中断模式：每 GONIO_NOTIFY_DECIMATE 次完整捕获检查一次，高电平宽度相对
+ *   上次通知变化超过 GONIO_NOTIFY_DEADBAND_TICKS 才唤醒线程；方向盘静止时不唤醒。
+ * - DMA 模式：由 DMA 半传输/传输完成回调进入，每半个环形缓冲区唤醒一次。
  */
 void app_gonio_dispose_ISP()
 {
+#if GONIO_CAPTURE_USE_DMA
+  gonio_dma_halves++;
+  app_gonio_NotifyFromISR();
+#else
+#if GONIO_PWM_EXTEND
   if (APP_GONIO_TIM.Channel == HAL_TIM_ACTIVE_CHANNEL_1)
   {
-    pwmPeriod = HAL_TIM_ReadCapturedValue(&APP_GONIO_TIM, TIM_CHANNEL_1);
+    u32 ccr1 = HAL_TIM_ReadCapturedValue(&APP_GONIO_TIM, TIM_CHANNEL_1);
+    s32 ovf = gonio_ovf;
+
+    /**
+     * @note 溢出挂起且 CCR1 很小：计数器先溢出、随后才来上升沿，
+     * 这个溢出属于刚结束的周期；它的更新中断稍后才会处理，先记 -1 抵消
+     */
+    if (__HAL_TIM_GET_FLAG(&APP_GONIO_TIM, TIM_FLAG_UPDATE) &&
+        ccr1 < 0x8000UL)
+    {
+      ovf++;
+      gonio_ovf = -1;
+    }
+    else
+    {
+      gonio_ovf = 0;
+    }
+    gonio_ovf_period = (u32)ovf;
+    return;
   }
-  else if (APP_GONIO_TIM.Channel == HAL_TIM_ACTIVE_CHANNEL_2)
+#endif
+  if (APP_GONIO_TIM.Channel == HAL_TIM_ACTIVE_CHANNEL_2)
   {
-    pulseWidth = HAL_TIM_ReadCapturedValue(&APP_GONIO_TIM, TIM_CHANNEL_2);
-    newData = bTRUE;
+    u32 period = HAL_TIM_ReadCapturedValue(&APP_GONIO_TIM, TIM_CHANNEL_1);
+    u32 high = HAL_TIM_ReadCapturedValue(&APP_GONIO_TIM, TIM_CHANNEL_2);
+#if GONIO_PWM_EXTEND
+    s32 ovf = gonio_ovf;
+
+    /* 同上：下降沿之前的溢出还没被更新中断计入 */
+    if (__HAL_TIM_GET_FLAG(&APP_GONIO_TIM, TIM_FLAG_UPDATE) &&
+        high < 0x8000UL)
+      ovf++;
+    high += (u32)ovf << 16;
+    period = (gonio_ovf_period > GONIO_PWM_OVF_MAX)
+                 ? 0U
+                 : (period + (gonio_ovf_period << 16));
+#endif
+    app_gonio_cap_advance(period);
+    app_gonio_stats_capture(period, high);
+
+    /* 上次唤醒线程的样本还没被取走就要被覆盖：线程跟不上 */
+    if ((s32)(gonio_cap_rd_seq - gonio_cap_wake_seq) < 0)
+      gonio_cap_dropped++;
+    app_gonio_cap_publish(period, high, gonio_cap_us,
+                          app_gonio_cap_unwrap(period, high));
+    gonio_last_edge_tick = xTaskGetTickCountFromISR();
+
+    if (++gonio_notify_cnt >= GONIO_NOTIFY_DECIMATE)
+    {
+      u32 diff = (high > gonio_notify_high) ? (high - gonio_notify_high)
+                                            : (gonio_notify_high - high);
+      gonio_notify_cnt = 0;
+      if (diff >= GONIO_NOTIFY_DEADBAND_TICKS)
+      {
+        gonio_notify_high = high;
+        gonio_cap_wake_seq = gonio_cap.seq;
+        app_gonio_NotifyFromISR();
+      }
+    }
   }
+#endif
+}
+
+/**
+ * @brief 定时器更新中断回调转发（由 stm32f1xx_it.c 调用）
+ * @note 没有 PWM 输入时计数器一直溢出，gonio_ovf 达到上限后不再增加，
+ * 恢复后的第一个周期按无效处理。
+ */
+void app_gonio_dispose_OVF_ISP()
+{
+#if GONIO_PWM_EXTEND
+  if (gonio_ovf <= (s32)GONIO_PWM_OVF_MAX)
+    gonio_ovf++;
+#endif
 }
 
 /**
  * @brief 转向判断线程
  * @note
  * 你的需求：
- * - 第一次有效数据为 0 点
- * - +90° 稳定为左转
- * - -90° 稳定为右转
+ * - 第一次有效数据为 0 点（或使用 Flash 标定的 0 点）
+ * - +turn_on 稳定为左转
+ * - -turn_on 稳定为右转
  *
  * 实现方式：
- * - 每 20ms 读取一次新角度（无新数据则跳过）
- * - 连续 STABLE_COUNT 次满足条件才触发事件
- * - LEFT/RIGHT 状态下必须先回到 CENTER 才允许切换（避免误闪另一侧）
+ * - 由捕获中断（或 DMA 半满/满）通知唤醒，不再固定 20ms 轮询
+ * - 阈值与保持时间来自运行时参数块（app_gonio_SetParam / "gonio param"），
+ *   线程在参数版本变化时复制一份，不需要重新编译
+ * - 滤波、角速度与状态机在 app_gonio_core 中（硬件无关），这里只负责
+ *   取样、把 tick 换算成 ms 交给核心、以及提交状态；等待超时设为核心给出的
+ *   剩余保持时间，方向盘静止不产生新通知时也能按时提交
  */
 void app_gonio_dispose_Task()
 {
@@ -210,133 +1071,220 @@ void app_gonio_dispose_Task()
 
   /* 无数据提示节流 */
   TickType_t last_nodata_tick = 0;
-  const TickType_t nodata_period = pdMS_TO_TICKS(1000);
+  const u32 nodata_ms = GONIO_NODATA_MS;
+  const TickType_t nodata_period = pdMS_TO_TICKS(nodata_ms);
 
-  app_steer_state_t state = APP_STEER_CENTER;
+  /* 参数本地副本，参数版本变化时刷新 */
+  app_gonio_param_t p;
+  u32 p_ver = 0;
+  TickType_t hold_ticks = 0;
 
-  const float TURN_ON_DEG = 90.0f; /* +90 左转 / -90 右转 */
-  const float CENTER_DEG = 30.0f;  /* 回正判定阈值（绝对值） */
-  const int STABLE_COUNT = 15;     /* 15*20ms≈300ms */
-  int left_cnt = 0, right_cnt = 0, center_cnt = 0;
+  /* 最近一次有效角度：无新通知时沿用，直到超过 hold_ms 没有捕获 */
+  s32 angle = 0;
+  bool has_angle = false;
+
+  gonio_task = xTaskGetCurrentTaskHandle();
+
+#if GONIO_BENCH_DECODE
+  app_gonio_bench_decode();
+#endif
 
   while (1)
   {
-    oboolean_t has_new = newData;
-    float angle = app_gonio_GetAngleDeg();
+    if (p_ver != gonio_param_ver)
+    {
+      taskENTER_CRITICAL();
+      p = gonio_param;
+      p_ver = gonio_param_ver;
+      taskEXIT_CRITICAL();
+
+      hold_ticks = pdMS_TO_TICKS(p.hold_ms);
+    }
+
+    /* 没有角度时核心已复位，没有需要按时检查的状态 */
+    u32 wait_ms = nodata_ms;
+    if (has_angle)
+      wait_ms = app_gonio_core_wait_ms(
+          &gonio_core, &p, app_gonio_tick_ms(xTaskGetTickCount()), nodata_ms);
+    TickType_t wait_ticks = pdMS_TO_TICKS(wait_ms);
+    (void)ulTaskNotifyTake(pdTRUE, wait_ticks);
+
+    TickType_t now = xTaskGetTickCount();
+    bool has_new = gonio_src->pending();
+    s32 new_angle = 0;
 
-    /* 无数据提示（注意：校零那一帧会返回 -1） */
-    if (!has_new && angle == -1)
+    if (app_gonio_GetAngleCdeg(&new_angle))
+    {
+      angle = new_angle;
+      has_angle = true;
+      app_gonio_core_velocity(&gonio_core, angle, gonio_sample_us);
+    }
+    else if (has_angle && (now - gonio_last_sample_tick) > hold_ticks)
+    {
+      has_angle = false;
+    }
+
+    /* 无数据提示（注意：校零那一帧会返回 false） */
+    if (!has_new && !has_angle)
     {
-      TickType_t now = xTaskGetTickCount();
       if ((now - last_nodata_tick) >= nodata_period)
       {
-        printf("[GONIO] 未捕获到PWM输入，请检查：PA6(TIM3_CH1)接线/供电/磁铁距离/定时器中断\r\n");
+        printf("[GONIO] %s\r\n", gonio_src->hint);
         last_nodata_tick = now;
       }
     }
 
-    if (angle == -1)
+    if (!has_angle)
     {
-      left_cnt = 0;
-      right_cnt = 0;
-      center_cnt = 0;
-      vTaskDelay(20);
+      app_gonio_core_reset(&gonio_core);
       continue;
     }
 
     /* 周期性打印（用于确认 0 点与 rel） */
     if (has_new)
     {
-      TickType_t now = xTaskGetTickCount();
       if ((now - last_print_tick) >= print_period)
       {
-        u32 period = pwmPeriod;
-        u32 high = pulseWidth;
+        app_gonio_capture_t cap;
+        int32_t rel_x100 = angle;
+        int32_t zero_x100 = inital_value;
 
-        u32 duty_x1000 = 0;
-        u32 absH_x100 = 0;
-        u32 absL_x100 = 0;
-        if (period != 0)
+        if (app_gonio_GetCapture(&cap))
         {
-          duty_x1000 = (high * 1000UL) / period;
-          absH_x100 = (high * 36000UL) / period;
-          absL_x100 = 36000UL - absH_x100;
-        }
+          u32 period = cap.period;
+          u32 high = cap.high;
 
-        int32_t rel_x100 = (int32_t)(angle * 100.0f);
-        int32_t zero_x100 = (int32_t)(inital_value * 100.0f);
+          /* 按 cdeg 解码，溢出扩展后的长周期也不会乘法溢出 */
+          u32 duty_x1000 = 0;
+          u32 absH_x100 = 0;
+          u32 absL_x100 = 0;
+          s32 absH = app_gonio_core_decode(period, high, false);
+          if (absH >= 0)
+          {
+            duty_x1000 = (u32)absH / 36U;
+            absH_x100 = (u32)absH;
+            absL_x100 = 36000UL - absH_x100;
+          }
 
-        printf("[GONIO] high=%lu, period=%lu, duty=%lu/1000, absH=%lu.%02lu, absL=%lu.%02lu, rel=%ld.%02ld, zero=%ld.%02ld\r\n",
-               (unsigned long)high, (unsigned long)period,
-               (unsigned long)duty_x1000, (unsigned long)(absH_x100 / 100),
-               (unsigned long)(absH_x100 % 100), (unsigned long)(absL_x100 / 100),
-               (unsigned long)(absL_x100 % 100), (long)(rel_x100 / 100),
-               (long)(rel_x100 < 0 ? (-rel_x100 % 100) : (rel_x100 % 100)),
-               (long)(zero_x100 / 100),
-               (long)(zero_x100 < 0 ? (-zero_x100 % 100) : (zero_x100 % 100)));
+          printf("[GONIO] high=%lu, period=%lu, duty=%lu/1000, absH=%lu.%02lu, absL=%lu.%02lu, rel=%ld.%02ld, zero=%ld.%02ld\r\n",
+                 (unsigned long)high, (unsigned long)period,
+                 (unsigned long)duty_x1000, (unsigned long)(absH_x100 / 100),
+                 (unsigned long)(absH_x100 % 100), (unsigned long)(absL_x100 / 100),
+                 (unsigned long)(absL_x100 % 100), (long)(rel_x100 / 100),
+                 (long)(rel_x100 < 0 ? (-rel_x100 % 100) : (rel_x100 % 100)),
+                 (long)(zero_x100 / 100),
+                 (long)(zero_x100 < 0 ? (-zero_x100 % 100) : (zero_x100 % 100)));
+        }
+        else
+        {
+          /* 非 PWM 角度源没有捕获快照 */
+          printf("[GONIO] rel=%ld.%02ld, zero=%ld.%02ld\r\n",
+                 (long)(rel_x100 / 100),
+                 (long)(rel_x100 < 0 ? (-rel_x100 % 100) : (rel_x100 % 100)),
+                 (long)(zero_x100 / 100),
+                 (long)(zero_x100 < 0 ? (-zero_x100 % 100) : (zero_x100 % 100)));
+        }
 
         last_print_tick = now;
       }
     }
 
     /* 转向状态机 */
-    switch (state)
+    if (app_gonio_core_step(&gonio_core, &p, angle, app_gonio_tick_ms(now)))
     {
-    case APP_STEER_CENTER:
-      if (angle >= TURN_ON_DEG)
-      {
-        left_cnt++;
-        right_cnt = 0;
-      }
-      else if (angle <= -TURN_ON_DEG)
-      {
-        right_cnt++;
-        left_cnt = 0;
-      }
-      else
-      {
-        left_cnt = 0;
-        right_cnt = 0;
-      }
+      app_state_update_steer(gonio_core.state);
+      xEventGroupSetBits(evt, SIG_LAMP_UPDATE | SIG_DISPLAY_UPDATE);
 
-      if (left_cnt >= STABLE_COUNT)
-      {
-        left_cnt = 0;
-        state = APP_STEER_LEFT;
-        app_state_update_steer(state);
-        xEventGroupSetBits(evt, SIG_LAMP_UPDATE | SIG_DISPLAY_UPDATE);
-      }
-      else if (right_cnt >= STABLE_COUNT)
-      {
-        right_cnt = 0;
-        state = APP_STEER_RIGHT;
-        app_state_update_steer(state);
-        xEventGroupSetBits(evt, SIG_LAMP_UPDATE | SIG_DISPLAY_UPDATE);
-      }
-      break;
+      if (gonio_core.predicted)
+        printf("[GONIO] predict steer=%d rel=%ld vel=%ld\r\n",
+               (int)gonio_core.state, (long)angle, (long)gonio_core.vel);
+    }
+  }
+}
 
-    case APP_STEER_LEFT:
-    case APP_STEER_RIGHT:
-    default:
-      if (angle <= CENTER_DEG && angle >= -CENTER_DEG)
-        center_cnt++;
-      else
-        center_cnt = 0;
+TIM_HandleTypeDef *app_gonio_getTIMHandle() { return &APP_GONIO_TIM; }
 
-      if (center_cnt >= STABLE_COUNT)
-      {
-        center_cnt = 0;
-        left_cnt = 0;
-        right_cnt = 0;
-        state = APP_STEER_CENTER;
-        app_state_update_steer(state);
-        xEventGroupSetBits(evt, SIG_LAMP_UPDATE | SIG_DISPLAY_UPDATE);
-      }
-      break;
-    }
+DMA_HandleTypeDef *app_gonio_getDMAHandle()
+{
+#if GONIO_CAPTURE_USE_DMA
+  return &APP_GONIO_DMA;
+#else
+  return NULL;
+#endif
+}
 
-    vTaskDelay(20);
+bool app_gonio_GetCapture(app_gonio_capture_t *out)
+{
+  if (out == NULL)
+    return false;
+  app_gonio_cap_read(out);
+  return out->seq != 0U;
+}
+
+u32 app_gonio_GetTickHz(void) { return GONIO_TIM_HZ; }
+
+u32 app_gonio_GetDropped(void) { return gonio_cap_dropped; }
+
+void app_gonio_GetParam(app_gonio_param_t *out)
+{
+  if (out == NULL)
+    return;
+
+  taskENTER_CRITICAL();
+  *out = gonio_param;
+  taskEXIT_CRITICAL();
+}
+
+RESULT_RUN app_gonio_SetParam(const app_gonio_param_t *param)
+{
+  const u32 MS_MAX = 60000U;
+
+  if (param == NULL)
+    return ERR_RUN_ERROR_UDIP;
+
+  /* 回正区（含滞回）与转向区（含滞回）不能重叠 */
+  if (param->center_cdeg < 0 || param->hyst_cdeg < 0 ||
+      param->turn_on_cdeg > GONIO_CDEG_180 ||
+      param->center_cdeg + param->hyst_cdeg >=
+          param->turn_on_cdeg - param->hyst_cdeg)
+    return ERR_RUN_ERROR_ERIP;
+  if (param->turn_ms > MS_MAX || param->center_ms > MS_MAX ||
+      param->predict_ms > MS_MAX || param->confirm_ms > MS_MAX ||
+      param->hold_ms == 0U || param->hold_ms > MS_MAX)
+    return ERR_RUN_ERROR_ERIP;
+
+  taskENTER_CRITICAL();
+  gonio_param = *param;
+  gonio_param_ver++;
+  taskEXIT_CRITICAL();
+  return ERR_RUN_Finished;
+}
+
+void app_gonio_GetStats(app_gonio_stats_t *out)
+{
+  if (out == NULL)
+    return;
+
+  taskENTER_CRITICAL();
+  *out = gonio_stats;
+  TickType_t last_edge = gonio_last_edge_tick;
+  taskEXIT_CRITICAL();
+
+  if (out->valid == 0U)
+  {
+    out->period_min = 0;
+    out->duty_min = 0;
   }
+  out->since_edge_ms =
+      (u32)(xTaskGetTickCount() - last_edge) * portTICK_PERIOD_MS;
 }
 
-TIM_HandleTypeDef *app_gonio_getTIMHandle() { return &APP_GONIO_TIM; }
+void app_gonio_ResetStats(void)
+{
+  taskENTER_CRITICAL();
+  memset(&gonio_stats, 0, sizeof(gonio_stats));
+  gonio_stats.period_min = 0xFFFFFFFFUL;
+  gonio_stats.duty_min = 0xFFFFFFFFUL;
+  gonio_stats_prev_period = 0;
+  taskEXIT_CRITICAL();
+}
@@ -12,13 +12,26 @@
 /* 头文件引用 */
 #include "ERR.h"
 #include "__port_type__.h"
+#include "app_gonio_core.h"
 #include "stm32f1xx_hal_tim.h"
+#include <stdbool.h>
 
 /* 宏定义 */
 // clang-format off
 
 # ifdef __APP_GONIO_C	/* 用于.c文件的宏 */
 
+/**
+ * @brief 角度源选择
+ * @note
+ * - 0：PA6 输入 PWM，TIM3 捕获（默认）
+ * - 1：SPI2 绝对编码器（AS5048A/AS5047），定时器触发 DMA 定速读取，
+ *   引脚与速率见 app_gonio_spi.h
+ */
+#ifndef GONIO_SOURCE_SPI
+#define GONIO_SOURCE_SPI 0
+#endif
+
 #define GONIO_PIN			GPIO_PIN_6		/* 指定GPIO引脚 */
 #define GONIO_GPIOx		GPIOA					/* 指定GPIO分组 */
 #define GONIO_TIMx		TIM3					/* 指定定时器 */
@@ -29,11 +42,140 @@
  * 不同磁编码器的 PWM 输出，可能“高电平宽度”或“低电平宽度”才是有效角度数据。
  * - 0：使用高电平宽度解码（默认）
  * - 1：使用低电平宽度解码（若你发现 high 很小而 low 变化大，可改为 1）
+ * 这里只是出厂默认值，Flash 中存在有效标定记录时以记录为准，
+ * 也可以通过调试串口 "gonio pol 0|1" 修改并保存。
  */
 #define GONIO_PWM_DECODE_USE_LOW_TIME 0
 
+/**
+ * @brief 捕获方式选择
+ * @note
+ * - 0：每个捕获沿进入 TIM3 中断（默认）
+ * - 1：TIM3 CC1 请求触发 DMA 突发读取 CCR1/CCR2 到环形缓冲区，捕获路径无中断，
+ *      线程每次唤醒处理整批样本，角度取窗口内的平均值
+ */
+#ifndef GONIO_CAPTURE_USE_DMA
+#define GONIO_CAPTURE_USE_DMA 0
+#endif
+
+/**
+ * @brief 定时器预分频自动选择
+ * @note
+ * - GONIO_PWM_EXPECT_HZ：传感器标称 PWM 频率
+ * - GONIO_PWM_FILL_TICKS：标称周期计数值的上限。预分频取满足该上限的最小值，
+ *   即不溢出前提下分辨率最高，留出的余量容忍传感器频率偏差
+ * - GONIO_PWM_MIN_HZ：可接受的最低 PWM 频率，更长的周期（如断线后计数器
+ *   一直溢出）按无效处理
+ * 72MHz、1kHz 时分频为 2，1 tick = 1/36us，标称周期 36000 tick。
+ */
+#define GONIO_PWM_EXPECT_HZ		1000UL
+#define GONIO_PWM_FILL_TICKS	0xC000UL
+#define GONIO_PWM_MIN_HZ			2UL
+
+/**
+ * @brief 溢出扩展
+ * @note 置 1 时另开 CC1（上升沿）与更新中断，用软件溢出计数把周期与高电平宽度
+ * 扩展到 32 位，比 GONIO_PWM_EXPECT_HZ 慢得多的 PWM 也能正确解码，
+ * 代价是每个周期多一次中断。DMA 模式只能搬运 16 位 CCR，不支持扩展。
+ */
+#ifndef GONIO_PWM_EXTEND
+#define GONIO_PWM_EXTEND 1
+#endif
+
+#define GONIO_DMA_CHANNEL			DMA1_Channel6	/* TIM3_CH1 对应的 DMA 通道 */
+#define GONIO_DMA_IRQn				DMA1_Channel6_IRQn
+#define GONIO_DMA_RING_PAIRS	64						/* 环形缓冲区可容纳的 {周期, 高电平} 对数 */
+
+/**
+ * @brief 事件驱动参数
+ * @note
+ * - GONIO_IRQ_PRIORITY：捕获/DMA 中断优先级，中断里要调用 FromISR 接口，
+ *   数值不能小于 configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY（5）
+ * 通知的抽取与死区（GONIO_NOTIFY_*）见 app_gonio_core.h，与主机回放工具共用。
+ */
+#define GONIO_IRQ_PRIORITY						5
+
+/**
+ * @brief 解码路径周期数对比
+ * @note 置 1 后线程启动时用 DWT->CYCCNT 分别测量旧 float 路径与 cdeg 路径
+ * 每个样本的周期数并打印；float 参考实现只在该宏打开时参与编译。
+ */
+#ifndef GONIO_BENCH_DECODE
+#define GONIO_BENCH_DECODE 0
+#endif
+#define GONIO_BENCH_LOOPS			1000U
+
 #endif
+
+/* 周期抖动直方图桶数：|Δperiod| 按 0、1、2~3、4~7 … 分桶，最后一桶为其余全部 */
+#define GONIO_STATS_JITTER_BINS	8
+
 // clang-format on
+
+/**
+ * @brief 一次完整捕获的快照
+ * @note 各字段总是来自同一次写入，由 seqlock 保证读端不会拿到拼接的值
+ */
+typedef struct
+{
+  u32 period; /* PWM 周期（单位：定时器 tick，见 app_gonio_GetTickHz） */
+  u32 high;   /* 高电平宽度（单位：定时器 tick） */
+  u32 t_us;   /* 捕获时间戳（单位：us，只用于求差值） */
+  u32 seq;    /* 样本序号，每次完整捕获加 1，0 表示还没有样本 */
+  s32 abs_cdeg;    /* 解码出的绝对角度，-1 表示无效或被多圈展开拒绝 */
+  s32 unwrap_base; /* 多圈展开起点（绝对角度） */
+  s32 unwrap_acc;  /* 多圈展开累加值，连续角度 = unwrap_base + unwrap_acc */
+} app_gonio_capture_t;
+
+/**
+ * @brief PWM 信号质量统计
+ * @note 由捕获路径累加，只做比较与计数，不格式化字符串
+ */
+typedef struct
+{
+  u32 valid;       /* 有效捕获数 */
+  u32 rej_period;  /* 拒绝：period == 0 */
+  u32 rej_high;    /* 拒绝：high == 0 或 high >= period */
+  u32 period_min;  /* 有效捕获的周期最小/最大值（单位：tick），无样本时为 0 */
+  u32 period_max;
+  u32 duty_min;    /* 有效捕获的占空比最小/最大值（单位：0.01%，0~10000） */
+  u32 duty_max;
+  u32 jitter_hist[GONIO_STATS_JITTER_BINS]; /* 相邻有效周期差值直方图 */
+  u32 since_edge_ms; /* 距最近一次捕获的时间（查询时计算） */
+} app_gonio_stats_t;
+
+/**
+ * @brief 角度源的一个样本
+ */
+typedef struct
+{
+  s32 abs_cdeg;    /* 绝对角度 [0, 36000)，-1 表示无效 */
+  s32 unwrap_base; /* 多圈展开起点（绝对角度） */
+  s32 unwrap_acc;  /* 多圈展开累加值 */
+  u32 t_us;        /* 采样时间戳（单位：us，只用于求差值） */
+} app_gonio_sample_t;
+
+/**
+ * @brief 角度源接口
+ * @note
+ * 每种传感器接口实现一份，多圈展开由实现自己在采样路径上完成，
+ * 上层只做 0 点、滤波与转向判定。read/pending 只在角度线程中调用，
+ * resync 可在任意线程调用，由实现在下次取样时处理。
+ */
+typedef struct
+{
+  const char *name; /* 名称，用于打印 */
+  const char *hint; /* 长时间无数据时的排查提示 */
+  RESULT_Init (*init)(void);
+  bool (*read)(app_gonio_sample_t *out); /* 取出新样本，没有新样本返回 false */
+  bool (*pending)(void);                 /* 是否有尚未取走的数据 */
+  void (*resync)(bool invert); /* 0 点/方向变化：以当前读数为起点重新展开 */
+  void (*show)(void);          /* 打印该角度源的计数（"gonio show"） */
+} app_gonio_source_t;
+
+/* PWM 角度源（TIM3 输入捕获） */
+extern const app_gonio_source_t app_gonio_source_pwm;
+
 /* 函数声明 */
 
 /**
@@ -44,12 +186,73 @@
 RESULT_Init app_gonio_init();
 
 /**
- * @brief 获取当前角度函数
+ * @brief 获取当前相对角度函数
  *
- * @return 当前角度值
+ * @param out_cdeg 输出相对角度，单位 cdeg（1° = 100），多圈展开后的连续值，
+ * 可超出 ±18000（满舵约 ±54000）
+ * @return 是否取得有效的新角度
  * @date 2025/12/9
  */
-float app_gonio_GetAngleDeg(void);
+bool app_gonio_GetAngleCdeg(s32 *out_cdeg);
+
+/**
+ * @brief 读取最新一次捕获快照
+ *
+ * @param out 输出快照
+ * @return 是否已有捕获样本
+ * @note 不关中断；可在任意线程调用，读到写入中途的数据时自动重读
+ */
+bool app_gonio_GetCapture(app_gonio_capture_t *out);
+
+/**
+ * @brief 获取捕获计数频率
+ *
+ * @return 定时器 tick 频率（Hz），由 GONIO_PWM_EXPECT_HZ 自动选择预分频得到
+ */
+u32 app_gonio_GetTickHz(void);
+
+/**
+ * @brief 获取丢弃的样本数
+ *
+ * @return 累计丢弃数
+ * @note
+ * - 中断模式：已唤醒线程的样本在线程取走之前被新样本覆盖的次数
+ * - DMA 模式：环形缓冲区被写端追上、未读数据被覆盖的样本数（按半缓冲区估计的下限）
+ * 持续增长说明角度线程跟不上传感器输出。
+ */
+u32 app_gonio_GetDropped(void);
+
+/**
+ * @brief 读取当前转向判定参数
+ *
+ * @param out 输出参数
+ */
+void app_gonio_GetParam(app_gonio_param_t *out);
+
+/**
+ * @brief 修改转向判定参数（立即生效，不写 Flash）
+ *
+ * @param param 新参数
+ * @return RESULT_RUN 运行结果，参数不合理时返回 ERR_RUN_ERROR_ERIP
+ * @note
+ * 要求 center、hyst 不小于 0，center + hyst < turn_on - hyst，turn_on <= 18000，
+ * 各时间不超过 60000ms，
+ * hold_ms 不为 0。角度线程在下一次唤醒时取用新参数。
+ */
+RESULT_RUN app_gonio_SetParam(const app_gonio_param_t *param);
+
+/**
+ * @brief 获取 PWM 信号质量统计
+ *
+ * @param out 输出统计值
+ * @note 在线程中调用；复制期间短暂进入临界区，保证各字段一致
+ */
+void app_gonio_GetStats(app_gonio_stats_t *out);
+
+/**
+ * @brief 清零 PWM 信号质量统计（丢弃计数不受影响）
+ */
+void app_gonio_ResetStats(void);
 
 /**
  * @brief 中断处理函数
@@ -57,6 +260,18 @@ float app_gonio_GetAngleDeg(void);
  */
 void app_gonio_dispose_ISP();
 
+/**
+ * @brief 定时器更新（计数溢出）中断处理函数
+ * @note 只在 GONIO_PWM_EXTEND=1 时有事可做
+ */
+void app_gonio_dispose_OVF_ISP();
+
+/**
+ * @brief 角度源在中断中唤醒角度线程
+ * @note 供各角度源的中断回调调用
+ */
+void app_gonio_NotifyFromISR(void);
+
 /**
  * @brief 线程处理函数
  * @date  2025/12/9
@@ -71,4 +286,11 @@ void app_gonio_dispose_Task();
  */
 TIM_HandleTypeDef *app_gonio_getTIMHandle();
 
+/**
+ * @brief 获取 DMA 句柄
+ *
+ * @return 捕获环形缓冲区所用 DMA 句柄，中断捕获模式下为 NULL
+ */
+DMA_HandleTypeDef *app_gonio_getDMAHandle();
+
 #endif
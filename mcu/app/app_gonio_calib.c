@@ -0,0 +1,204 @@
+/**
+ * @file		app_gonio_calib.c
+ * @brief		用于定义操作该模块的函数
+ * @note		方向盘零点标定（Flash 持久化）
+ * @author	王广平
+ *
+ * @note
+ * 1) 使用 Flash 最后两页（链接脚本中已从 FLASH 区域划出），每页 32 条 32 字节记录。
+ * 2) 新记录总是追加到当前页的下一个空位，序号 seq 递增；当前页写满时擦除另一页
+ *    并从头写入。两页中 seq 最大的有效记录即为当前标定。
+ * 3) 记录带魔数、版本和 CRC32，掉电写了一半的记录会因 CRC 错误被跳过，
+ *    自动回退到上一条有效记录。
+ */
+
+#define __APP_GONIO_CALIB_C
+
+/* 头文件引用 */
+#include "app_gonio_calib.h"
+#include "bsp_flash.h"
+#include <stddef.h>
+
+/* Flash 中的记录格式（32 字节，半字对齐） */
+typedef struct
+{
+  u16 magic;
+  u8 version;
+  u8 flags; /* bit0：decode_low */
+  s32 zero_cdeg;
+  u32 seq;
+  u16 turn_on_cdeg; /* 以下为 app_gonio_param_t，按 u16 压缩存放 */
+  u16 center_cdeg;
+  u16 hyst_cdeg;
+  u16 turn_ms;
+  u16 center_ms;
+  u16 hold_ms;
+  u16 predict_ms;
+  u16 confirm_ms;
+  u32 crc; /* crc 之前所有字节的 CRC32 */
+} gonio_calib_rec_t;
+
+#define GONIO_CALIB_SLOTS (BSP_FLASH_PAGE_SIZE / sizeof(gonio_calib_rec_t))
+#define GONIO_CALIB_FLAG_LOW 0x01U
+
+/* 当前写入位置（由 load 确定，save 时使用） */
+static u32 calib_page = GONIO_CALIB_PAGE0;
+static u32 calib_next = 0;
+static u32 calib_seq = 0;
+static bool calib_scanned = false;
+
+/**
+ * @brief CRC32（多项式 0xEDB88320，按位计算，不占用查表空间）
+ */
+static u32 app_gonio_calib_crc32(const u8 *p, u32 len)
+{
+  u32 crc = 0xFFFFFFFFUL;
+  u32 i = 0;
+  u8 b = 0;
+
+  for (i = 0; i < len; i++)
+  {
+    crc ^= p[i];
+    for (b = 0; b < 8; b++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+  }
+  return ~crc;
+}
+
+static inline const gonio_calib_rec_t *app_gonio_calib_slot(u32 page, u32 i)
+{
+  return (const gonio_calib_rec_t *)(page + i * sizeof(gonio_calib_rec_t));
+}
+
+static bool app_gonio_calib_valid(const gonio_calib_rec_t *rec)
+{
+  return rec->magic == GONIO_CALIB_MAGIC &&
+         rec->version == GONIO_CALIB_VERSION &&
+         rec->crc == app_gonio_calib_crc32((const u8 *)rec,
+                                           offsetof(gonio_calib_rec_t, crc));
+}
+
+/**
+ * @brief 扫描一页，返回已用槽位数，并给出最后一条有效记录
+ */
+static u32 app_gonio_calib_scan(u32 page, const gonio_calib_rec_t **last)
+{
+  u32 used = 0;
+  u32 i = 0;
+
+  while (used < GONIO_CALIB_SLOTS &&
+         app_gonio_calib_slot(page, used)->magic != 0xFFFFU)
+    used++;
+
+  *last = NULL;
+  for (i = used; i > 0; i--)
+  {
+    const gonio_calib_rec_t *rec = app_gonio_calib_slot(page, i - 1U);
+    if (app_gonio_calib_valid(rec))
+    {
+      *last = rec;
+      break;
+    }
+  }
+  return used;
+}
+
+bool app_gonio_calib_load(app_gonio_calib_t *out)
+{
+  const gonio_calib_rec_t *last0 = NULL;
+  const gonio_calib_rec_t *last1 = NULL;
+  const gonio_calib_rec_t *best = NULL;
+  u32 used0 = app_gonio_calib_scan(GONIO_CALIB_PAGE0, &last0);
+  u32 used1 = app_gonio_calib_scan(GONIO_CALIB_PAGE1, &last1);
+
+  /* 选出 seq 最大的有效记录，并把写入位置定在它所在的页 */
+  if (last0 != NULL && (last1 == NULL || last0->seq > last1->seq))
+  {
+    best = last0;
+    calib_page = GONIO_CALIB_PAGE0;
+    calib_next = used0;
+  }
+  else if (last1 != NULL)
+  {
+    best = last1;
+    calib_page = GONIO_CALIB_PAGE1;
+    calib_next = used1;
+  }
+  else
+  {
+    calib_page = GONIO_CALIB_PAGE0;
+    calib_next = used0;
+  }
+  calib_seq = (best != NULL) ? best->seq : 0;
+  calib_scanned = true;
+
+  if (best == NULL || out == NULL)
+    return false;
+
+  out->zero_cdeg = best->zero_cdeg;
+  out->decode_low = (best->flags & GONIO_CALIB_FLAG_LOW) != 0U;
+  out->param.turn_on_cdeg = best->turn_on_cdeg;
+  out->param.center_cdeg = best->center_cdeg;
+  out->param.hyst_cdeg = best->hyst_cdeg;
+  out->param.turn_ms = best->turn_ms;
+  out->param.center_ms = best->center_ms;
+  out->param.hold_ms = best->hold_ms;
+  out->param.predict_ms = best->predict_ms;
+  out->param.confirm_ms = best->confirm_ms;
+  return true;
+}
+
+RESULT_RUN app_gonio_calib_save(const app_gonio_calib_t *cal)
+{
+  gonio_calib_rec_t rec;
+  RESULT_RUN ret = ERR_RUN_Finished;
+
+  if (cal == NULL)
+    return ERR_RUN_ERROR_UDIP;
+
+  if (!calib_scanned)
+    (void)app_gonio_calib_load(NULL);
+
+  /* 当前页写满：换到另一页 */
+  if (calib_next >= GONIO_CALIB_SLOTS)
+  {
+    calib_page = (calib_page == GONIO_CALIB_PAGE0) ? GONIO_CALIB_PAGE1
+                                                   : GONIO_CALIB_PAGE0;
+    calib_next = 0;
+  }
+
+  /* 写入新页的第一条之前擦除该页（另一页仍保留旧记录） */
+  if (calib_next == 0 &&
+      app_gonio_calib_slot(calib_page, 0)->magic != 0xFFFFU)
+  {
+    ret = bsp_flash_erase_page(calib_page);
+    if (ret != ERR_RUN_Finished)
+      return ret;
+  }
+
+  rec.magic = GONIO_CALIB_MAGIC;
+  rec.version = GONIO_CALIB_VERSION;
+  rec.flags = cal->decode_low ? GONIO_CALIB_FLAG_LOW : 0U;
+  rec.zero_cdeg = cal->zero_cdeg;
+  rec.seq = calib_seq + 1U;
+  rec.turn_on_cdeg = (u16)cal->param.turn_on_cdeg;
+  rec.center_cdeg = (u16)cal->param.center_cdeg;
+  rec.hyst_cdeg = (u16)cal->param.hyst_cdeg;
+  rec.turn_ms = (u16)cal->param.turn_ms;
+  rec.center_ms = (u16)cal->param.center_ms;
+  rec.hold_ms = (u16)cal->param.hold_ms;
+  rec.predict_ms = (u16)cal->param.predict_ms;
+  rec.confirm_ms = (u16)cal->param.confirm_ms;
+  rec.crc =
+      app_gonio_calib_crc32((const u8 *)&rec, offsetof(gonio_calib_rec_t, crc));
+
+  ret = bsp_flash_write(
+      (u32)app_gonio_calib_slot(calib_page, calib_next), &rec, sizeof(rec));
+  /* 写失败的槽位也视为已占用，下次从后一个槽位开始 */
+  calib_next++;
+  if (ret != ERR_RUN_Finished)
+    return ret;
+
+  calib_seq = rec.seq;
+  return ERR_RUN_Finished;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file		app_gonio_calib.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		方向盘零点标定（Flash 持久化）
+ * @author	王广平
+ **/
+
+#ifndef __APP_GONIO_CALIB_H
+#define __APP_GONIO_CALIB_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+#include "app_gonio_core.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+// clang-format off
+
+#ifdef __APP_GONIO_CALIB_C	/* 用于.c文件的宏 */
+
+#define GONIO_CALIB_PAGE0			0x0800F800UL	/* 倒数第二页 */
+#define GONIO_CALIB_PAGE1			0x0800FC00UL	/* 最后一页 */
+#define GONIO_CALIB_MAGIC			0xCA1BU
+#define GONIO_CALIB_VERSION		2U		/* v2：记录增加转向判定参数，长度 32 字节 */
+
+#endif
+// clang-format on
+
+/* 标定数据 */
+typedef struct
+{
+  s32 zero_cdeg;   /* 方向盘 0 点对应的绝对角度（单位：cdeg） */
+  bool decode_low; /* true：用低电平宽度解码 */
+  app_gonio_param_t param; /* 转向判定参数 */
+} app_gonio_calib_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 从 Flash 读取最新的标定记录
+ *
+ * @param out 输出标定数据
+ * @return 是否存在有效记录（魔数、版本、CRC 均正确）
+ * @note 旧版本记录视为无效，回退到默认值
+ * @note 只扫描两页的记录头并校验最后一条，启动时耗时为微秒级
+ */
+bool app_gonio_calib_load(app_gonio_calib_t *out);
+
+/**
+ * @brief 追加写入一条标定记录
+ *
+ * @param cal 标定数据
+ * @return RESULT_RUN 运行结果
+ * @note
+ * 记录在两页之间顺序追加（磨损均衡），当前页写满才擦除另一页；
+ * 擦除期间 CPU 会被挂起，只应在调试命令等非实时路径调用。
+ */
+RESULT_RUN app_gonio_calib_save(const app_gonio_calib_t *cal);
+
+#endif
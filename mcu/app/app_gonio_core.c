@@ -0,0 +1,449 @@
+/**
+ * @file		app_gonio_core.c
+ * @brief		用于定义操作该模块的函数
+ * @note		角度测量模块的硬件无关部分
+ * @author	王广平
+ **/
+
+#define __APP_GONIO_CORE_C
+
+/* 头文件引用 */
+#include "app_gonio_core.h"
+
+/* ============================== 解码 ============================== */
+
+/**
+ * @note abs = high * 36000 / period，四舍五入。
+ * 溢出扩展后 period 可超过 16 位，先把 period/high 同时右移到
+ * period <= GONIO_DECODE_PERIOD_MAX，保证乘积不超过 u32 范围，
+ * 此时仍有 1/59652 的分辨率，远小于 1 cdeg。
+ */
+#define GONIO_DECODE_PERIOD_MAX (0xFFFFFFFFUL / GONIO_CDEG_360)
+
+s32 app_gonio_core_decode(u32 period, u32 high, bool use_low)
+{
+  /* 过滤明显无效的捕获：period==0 / high==0 / high>=period */
+  if (period == 0 || high == 0 || high >= period)
+    return -1;
+
+  while (period > GONIO_DECODE_PERIOD_MAX)
+  {
+    period >>= 1;
+    high >>= 1;
+  }
+  if (high == 0)
+    return -1;
+
+  /* 绝对角度（0~36000 循环） */
+  s32 abs_cdeg =
+      (s32)((high * (u32)GONIO_CDEG_360 + (period >> 1)) / period);
+  if (use_low)
+    abs_cdeg = GONIO_CDEG_360 - abs_cdeg;
+
+  /* 规范化到 [0, 36000) */
+  if (abs_cdeg >= GONIO_CDEG_360)
+    abs_cdeg = 0;
+
+  return abs_cdeg;
+}
+
+/**
+ * @note 整帧 16 位的 1 的个数为偶数才有效；14 位角度按 36000/16384 换算，四舍五入。
+ */
+app_gonio_spi_frame_t app_gonio_core_spi_frame(u16 frame, bool invert,
+                                               s32 *out_abs)
+{
+  u32 x = frame;
+
+  x ^= x >> 8;
+  x ^= x >> 4;
+  x ^= x >> 2;
+  x ^= x >> 1;
+  if ((x & 1U) != 0U)
+    return GONIO_SPI_FRAME_PARITY;
+  if ((frame & 0x4000U) != 0U)
+    return GONIO_SPI_FRAME_EF;
+
+  s32 abs_cdeg =
+      (s32)(((frame & 0x3FFFU) * (u32)GONIO_CDEG_360 + 0x2000U) >> 14);
+  if (invert)
+    abs_cdeg = GONIO_CDEG_360 - abs_cdeg;
+  if (abs_cdeg >= GONIO_CDEG_360)
+    abs_cdeg = 0;
+
+  *out_abs = abs_cdeg;
+  return GONIO_SPI_FRAME_OK;
+}
+
+app_gonio_spi_frame_t app_gonio_core_spi_sample(app_gonio_unwrap_t *u,
+                                                u16 frame, bool invert,
+                                                u32 t_us, s32 *out_abs)
+{
+  s32 abs_cdeg = -1;
+  app_gonio_spi_frame_t r = app_gonio_core_spi_frame(frame, invert, &abs_cdeg);
+
+  if (r != GONIO_SPI_FRAME_OK)
+    return r;
+  if (!app_gonio_core_unwrap(u, abs_cdeg, t_us))
+    return GONIO_SPI_FRAME_REJECT;
+
+  *out_abs = abs_cdeg;
+  return GONIO_SPI_FRAME_OK;
+}
+
+/* ============================== 多圈展开 ============================== */
+
+void app_gonio_core_unwrap_init(app_gonio_unwrap_t *u)
+{
+  u->prev_abs = -1;
+  u->base_abs = 0;
+  u->acc = 0;
+  u->prev_us = 0;
+  u->reject_run = 0;
+}
+
+/**
+ * @brief 相邻读数之间允许的最大角度变化
+ * @note 距上一次接受的读数越久阈值越大，被拒绝的读数不更新 prev_us，
+ * 因此连续的毛刺之后阈值会逐渐放宽。
+ */
+static inline s32 app_gonio_core_unwrap_limit(u32 dt_us)
+{
+  if (dt_us >= GONIO_UNWRAP_MAX_DT_US)
+    return GONIO_CDEG_180;
+
+  s32 limit = (s32)((dt_us * (u32)GONIO_UNWRAP_RATE_Q10) >> 10);
+  return (limit < GONIO_UNWRAP_MIN_STEP_CDEG) ? GONIO_UNWRAP_MIN_STEP_CDEG
+                                               : limit;
+}
+
+/**
+ * @note
+ * 相邻读数之差先 wrap 到 ±180°，即取最短路径，再用一次无符号比较检查
+ * |delta| <= 最大角速度 × 时间间隔；只有乘法、移位和比较，没有除法。
+ */
+bool app_gonio_core_unwrap(app_gonio_unwrap_t *u, s32 abs_cdeg, u32 t_us)
+{
+  if (abs_cdeg < 0)
+    return false;
+
+  if (u->prev_abs < 0)
+  {
+    u->prev_abs = abs_cdeg;
+    u->base_abs = abs_cdeg;
+    u->acc = 0;
+    u->prev_us = t_us;
+    return true;
+  }
+
+  s32 delta = app_gonio_core_wrap_180(abs_cdeg - u->prev_abs);
+  s32 limit = app_gonio_core_unwrap_limit(t_us - u->prev_us);
+  if ((u32)(delta + limit) > (u32)(2 * limit) &&
+      ++u->reject_run < GONIO_UNWRAP_RESYNC)
+  {
+    u->rejects++;
+    return false;
+  }
+
+  u->reject_run = 0;
+  u->prev_abs = abs_cdeg;
+  u->prev_us = t_us;
+  u->acc += delta;
+  return true;
+}
+
+/* ============================== 滤波 ============================== */
+#if GONIO_FILTER_MEDIAN_N > 1
+/**
+ * @brief 滑动中值窗口
+ * @note
+ * hist 按到达顺序保存样本（环形），sorted 保持升序。每来一个新样本只需
+ * 在 sorted 中移走最老的样本并插入新样本，窗口长度编译期固定，
+ * 单样本代价固定为 O(N) 次比较/搬移，与运行时间无关。
+ */
+static s32 app_gonio_core_median_push(app_gonio_core_t *c, s32 x)
+{
+  u32 n = c->med_count;
+  u32 i = 0;
+
+  if (n == GONIO_FILTER_MEDIAN_N)
+  {
+    /* 从有序表中移除最老的样本 */
+    s32 old = c->med_hist[c->med_head];
+    while (c->med_sorted[i] != old)
+      i++;
+    for (; i + 1 < n; i++)
+      c->med_sorted[i] = c->med_sorted[i + 1];
+    n--;
+  }
+  else
+  {
+    c->med_count++;
+  }
+
+  /* 插入排序放入新样本 */
+  i = n;
+  while (i > 0 && c->med_sorted[i - 1] > x)
+  {
+    c->med_sorted[i] = c->med_sorted[i - 1];
+    i--;
+  }
+  c->med_sorted[i] = x;
+
+  c->med_hist[c->med_head] = x;
+  c->med_head = (c->med_head + 1) % GONIO_FILTER_MEDIAN_N;
+
+  return c->med_sorted[c->med_count >> 1];
+}
+#endif
+
+#if GONIO_FILTER_IIR_SHIFT > 0
+/**
+ * @brief 一阶 IIR：y += (x - y) / 2^shift
+ * @note 状态放大 2^shift 保存，避免小步长时整数截断导致的稳态误差。
+ */
+static s32 app_gonio_core_iir_push(app_gonio_core_t *c, s32 x)
+{
+  if (!c->iir_inited)
+  {
+    c->iir_inited = true;
+    c->iir_acc = x * (1 << GONIO_FILTER_IIR_SHIFT);
+  }
+  else
+  {
+    c->iir_acc += x - (c->iir_acc >> GONIO_FILTER_IIR_SHIFT);
+  }
+  return c->iir_acc >> GONIO_FILTER_IIR_SHIFT;
+}
+#endif
+
+s32 app_gonio_core_filter(app_gonio_core_t *c, s32 rel_cdeg)
+{
+#if GONIO_FILTER_MEDIAN_N > 1
+  rel_cdeg = app_gonio_core_median_push(c, rel_cdeg);
+#endif
+#if GONIO_FILTER_IIR_SHIFT > 0
+  rel_cdeg = app_gonio_core_iir_push(c, rel_cdeg);
+#endif
+#if GONIO_FILTER_MEDIAN_N <= 1 && GONIO_FILTER_IIR_SHIFT <= 0
+  (void)c;
+#endif
+  return rel_cdeg;
+}
+
+/* ============================== 角速度估计 ============================== */
+
+/**
+ * @note
+ * 按捕获时间戳做有限差分。两次采样间隔小于 GONIO_VEL_MIN_DT_US 时不更新锚点，
+ * 以免分母过小放大量化噪声；结果再经过 1/2 的一阶平滑。
+ * 间隔不小于 10ms 时 delta*1000 不会超出 s32，整个计算不需要 64 位除法。
+ */
+void app_gonio_core_velocity(app_gonio_core_t *c, s32 rel_cdeg, u32 t_us)
+{
+#if GONIO_PREDICT_ENABLE
+  if (!c->vel_inited)
+  {
+    c->vel_inited = true;
+    c->vel = 0;
+    c->vel_prev_cdeg = rel_cdeg;
+    c->vel_prev_us = t_us;
+    return;
+  }
+
+  u32 dt_us = t_us - c->vel_prev_us;
+  if (dt_us < GONIO_VEL_MIN_DT_US)
+    return;
+
+  s32 d = rel_cdeg - c->vel_prev_cdeg;
+  s32 v = (d * 1000) / (s32)(dt_us / 1000U);
+  c->vel += (v - c->vel) / 2;
+
+  c->vel_prev_cdeg = rel_cdeg;
+  c->vel_prev_us = t_us;
+#else
+  (void)c;
+  (void)rel_cdeg;
+  (void)t_us;
+#endif
+}
+
+#if GONIO_PREDICT_ENABLE
+/**
+ * @brief 预测角度 a 是否会在前瞻时间内到达 on（a、v 已折算到同一侧为正）
+ */
+static inline bool app_gonio_core_predict_reach(s32 a, s32 v, s32 on)
+{
+  if (a < GONIO_PREDICT_MIN_CDEG || v < GONIO_PREDICT_VEL_CDEG_S)
+    return false;
+  return (a + (v * GONIO_PREDICT_LOOKAHEAD_MS) / 1000) >= on;
+}
+#endif
+
+/* ============================== 状态机 ============================== */
+
+void app_gonio_core_reset(app_gonio_core_t *c)
+{
+#if GONIO_FILTER_MEDIAN_N > 1
+  c->med_head = 0;
+  c->med_count = 0;
+#endif
+#if GONIO_FILTER_IIR_SHIFT > 0
+  c->iir_inited = false;
+#endif
+  c->vel = 0;
+  c->vel_inited = false;
+  c->cand = c->state;
+}
+
+void app_gonio_core_init(app_gonio_core_t *c)
+{
+  c->state = APP_STEER_CENTER;
+  c->predicted = false;
+  c->predicted_since_ms = 0;
+  c->cand_since_ms = 0;
+  c->cand_dwell_ms = 0;
+  app_gonio_core_reset(c);
+}
+
+/**
+ * @note
+ * 预测提交后方向盘可能停在阈值以内：角度不再变化，捕获中断因死区不再
+ * 通知线程，只能靠超时醒来。因此除候选状态外，还要按 confirm_ms 的
+ * 剩余时间醒来，才能准时撤销未确认的预测。
+ */
+u32 app_gonio_core_wait_ms(const app_gonio_core_t *c, const app_gonio_param_t *p,
+                           u32 now_ms, u32 idle_ms)
+{
+  u32 wait = idle_ms;
+  u32 elapsed = 0;
+
+  if (c->cand != c->state)
+  {
+    elapsed = now_ms - c->cand_since_ms;
+    if (elapsed >= c->cand_dwell_ms)
+      return 0;
+    wait = c->cand_dwell_ms - elapsed;
+  }
+
+#if GONIO_PREDICT_ENABLE
+  if (c->predicted)
+  {
+    elapsed = now_ms - c->predicted_since_ms;
+    if (elapsed >= p->confirm_ms)
+      return 0;
+    if (p->confirm_ms - elapsed < wait)
+      wait = p->confirm_ms - elapsed;
+  }
+#else
+  (void)p;
+#endif
+
+  return (wait < idle_ms) ? wait : idle_ms;
+}
+
+/**
+ * @note
+ * - 条件满足后持续 turn_ms / center_ms 才提交，按时间戳计时而不是按调用次数
+ * - 滞回：候选状态计时期间阈值放宽 hyst_cdeg，角度在阈值附近抖动不会重新计时
+ * - LEFT/RIGHT 状态下必须先回到 CENTER 才允许切换（避免误闪另一侧）
+ * - 预测触发（GONIO_PREDICT_ENABLE）：方向盘快速转向阈值时，按角速度外推
+ *   GONIO_PREDICT_LOOKAHEAD_MS 后能越过阈值，则只需 predict_ms 即提交；
+ *   提交后若在 confirm_ms 内没有真正越过阈值，或方向盘以
+ *   GONIO_PREDICT_CANCEL_VEL_CDEG_S 以上的速度回转，则立即撤销回 CENTER
+ */
+bool app_gonio_core_step(app_gonio_core_t *c, const app_gonio_param_t *p,
+                         s32 angle, u32 now_ms)
+{
+  /* 先求出当前角度期望的状态 */
+  app_steer_state_t want = c->state;
+  u32 want_dwell = 0;
+  bool want_pred = false; /* want 是否来自预测条件 */
+
+  switch (c->state)
+  {
+  case APP_STEER_CENTER:
+  {
+    s32 on_l = p->turn_on_cdeg - ((c->cand == APP_STEER_LEFT) ? p->hyst_cdeg : 0);
+    s32 on_r =
+        p->turn_on_cdeg - ((c->cand == APP_STEER_RIGHT) ? p->hyst_cdeg : 0);
+
+    want_dwell = p->turn_ms;
+#if GONIO_PREDICT_ENABLE
+    if (app_gonio_core_predict_reach(angle, c->vel, p->turn_on_cdeg))
+    {
+      want = APP_STEER_LEFT;
+      want_dwell = p->predict_ms;
+      want_pred = true;
+      break;
+    }
+    if (app_gonio_core_predict_reach(-angle, -c->vel, p->turn_on_cdeg))
+    {
+      want = APP_STEER_RIGHT;
+      want_dwell = p->predict_ms;
+      want_pred = true;
+      break;
+    }
+#endif
+    if (angle >= on_l)
+      want = APP_STEER_LEFT;
+    else if (angle <= -on_r)
+      want = APP_STEER_RIGHT;
+    break;
+  }
+
+  case APP_STEER_LEFT:
+  case APP_STEER_RIGHT:
+  default:
+  {
+    s32 ctr = p->center_cdeg + ((c->cand == APP_STEER_CENTER) ? p->hyst_cdeg : 0);
+
+    want_dwell = p->center_ms;
+    if (angle <= ctr && angle >= -ctr)
+      want = APP_STEER_CENTER;
+#if GONIO_PREDICT_ENABLE
+    else if (c->predicted)
+    {
+      s32 side_angle = (c->state == APP_STEER_LEFT) ? angle : -angle;
+      s32 side_vel = (c->state == APP_STEER_LEFT) ? c->vel : -c->vel;
+
+      if (side_angle >= p->turn_on_cdeg)
+      {
+        /* 真实角度已越过阈值，预测得到确认 */
+        c->predicted = false;
+      }
+      else if ((now_ms - c->predicted_since_ms) >= p->confirm_ms ||
+               side_vel <= -GONIO_PREDICT_CANCEL_VEL_CDEG_S)
+      {
+        /* 未确认或方向盘回转：立即撤销，不等待回正稳定时间 */
+        want = APP_STEER_CENTER;
+        want_dwell = 0;
+      }
+    }
+#endif
+    break;
+  }
+  }
+
+  /* 期望状态需持续 cand_dwell_ms 才提交 */
+  if (want == c->state)
+  {
+    c->cand = c->state;
+    return false;
+  }
+  if (want != c->cand)
+  {
+    c->cand = want;
+    c->cand_since_ms = now_ms;
+  }
+  c->cand_dwell_ms = want_dwell;
+
+  if ((now_ms - c->cand_since_ms) < c->cand_dwell_ms)
+    return false;
+
+  c->state = c->cand;
+  c->predicted = want_pred && (angle < p->turn_on_cdeg) &&
+                 (angle > -p->turn_on_cdeg);
+  c->predicted_since_ms = now_ms;
+  return true;
+}
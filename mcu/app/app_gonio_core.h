@@ -0,0 +1,333 @@
+/**
+ * @file		app_gonio_core.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		角度测量模块的硬件无关部分：解码、滤波、角速度与转向状态机
+ * @author	王广平
+ *
+ * @note
+ * 本模块不依赖 HAL / FreeRTOS，只用整数运算，时间由调用者以 ms / us 传入，
+ * 因此既可以在 MCU 上由 app_gonio 驱动，也可以直接在主机上编译，
+ * 用录制的 {时间戳, 周期, 高电平} 序列回放验证阈值与滤波参数。
+ **/
+
+#ifndef __APP_GONIO_CORE_H
+#define __APP_GONIO_CORE_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+#include "app_state.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+// clang-format off
+
+#ifdef __APP_GONIO_CORE_C	/* 用于.c文件的宏 */
+
+/**
+ * @brief 预测触发参数（角速度单位：cdeg/s）
+ * @note
+ * - GONIO_PREDICT_MIN_CDEG：角度至少到达该值才考虑预测
+ * - GONIO_PREDICT_VEL_CDEG_S：朝阈值方向的角速度至少为该值
+ * - GONIO_PREDICT_LOOKAHEAD_MS：按当前角速度外推的时间
+ * - GONIO_PREDICT_CANCEL_VEL_CDEG_S：未确认期间回转速度超过该值立即撤销
+ * - GONIO_VEL_MIN_DT_US：有限差分的最小时间间隔
+ * 预测需保持的时间与确认时间在 app_gonio_param_t 中，可运行时修改。
+ */
+#ifndef GONIO_PREDICT_ENABLE
+#define GONIO_PREDICT_ENABLE					1
+#endif
+#define GONIO_PREDICT_MIN_CDEG				4500
+#define GONIO_PREDICT_VEL_CDEG_S			18000
+#define GONIO_PREDICT_LOOKAHEAD_MS		200
+#define GONIO_PREDICT_CANCEL_VEL_CDEG_S	9000
+#define GONIO_VEL_MIN_DT_US						10000U
+
+/**
+ * @brief 多圈展开参数
+ * @note
+ * - GONIO_UNWRAP_MAX_RATE_CDEG_S：方向盘物理上可能达到的最大角速度。
+ *   相邻两次读数之间允许的变化 = 该角速度 × 两次读数的时间间隔，
+ *   超过视为毛刺（磁铁/线路干扰），不计入累加；PWM 频率或 SPI 读取速率
+ *   改变时阈值随之缩放，不需要单独调整
+ * - GONIO_UNWRAP_MIN_STEP_CDEG：阈值下限，读取速率很高时容纳传感器本身的读数噪声
+ * - GONIO_UNWRAP_RESYNC：连续拒绝该次数后认为确实发生了跳变（如信号中断期间
+ *   方向盘被转动），接受新读数并继续累加
+ */
+#define GONIO_UNWRAP_MAX_RATE_CDEG_S	300000
+#define GONIO_UNWRAP_MIN_STEP_CDEG		500
+#define GONIO_UNWRAP_RESYNC						8U
+
+/* 角速度换算为 cdeg/us（Q10），以及阈值达到 180° 时的时间间隔 */
+#define GONIO_UNWRAP_RATE_Q10 \
+  ((s32)(((u64)GONIO_UNWRAP_MAX_RATE_CDEG_S * 1024U + 500000U) / 1000000U))
+#define GONIO_UNWRAP_MAX_DT_US \
+  ((u32)(((u64)GONIO_CDEG_180 << 10) / (u32)GONIO_UNWRAP_RATE_Q10))
+
+#endif
+
+/**
+ * @brief 转向判定参数的默认值（运行时可通过 app_gonio_SetParam 修改）
+ * @note
+ * 与参数结构体放在一起，主机回放工具与固件使用同一组默认值：
+ * - GONIO_TURN_ON_CDEG：转向阈值（绝对值），+90° 左转 / -90° 右转
+ * - GONIO_CENTER_CDEG：回正阈值（绝对值）
+ * - GONIO_HYST_CDEG：滞回，候选状态计时期间阈值放宽的量，
+ *   角度在阈值附近抖动时不会反复重新计时
+ * - GONIO_TURN_MS：CENTER -> LEFT/RIGHT 条件需持续的时间
+ * - GONIO_CENTER_MS：LEFT/RIGHT -> CENTER 条件需持续的时间
+ * - GONIO_HOLD_MS：超过该时间没有任何捕获，认为信号丢失，不再沿用旧角度
+ */
+#define GONIO_TURN_ON_CDEG						9000
+#define GONIO_CENTER_CDEG							3000
+#define GONIO_HYST_CDEG								300
+#define GONIO_TURN_MS									300
+#define GONIO_CENTER_MS								300
+#define GONIO_HOLD_MS									100
+
+/**
+ * @brief 预测触发的保持/确认时间默认值（运行时可修改）
+ * @note
+ * - GONIO_PREDICT_STABLE_MS：预测条件需持续的时间
+ * - GONIO_PREDICT_CONFIRM_MS：提前提交后，须在该时间内真正越过阈值
+ * 其余预测参数见上方 __APP_GONIO_CORE_C 宏块。
+ */
+#define GONIO_PREDICT_STABLE_MS				60
+#define GONIO_PREDICT_CONFIRM_MS			600
+
+/**
+ * @brief 线程唤醒参数（固件与主机回放工具共用）
+ * @note
+ * - GONIO_NOTIFY_DECIMATE：中断模式下每 N 次捕获最多通知线程一次
+ * - GONIO_NOTIFY_DEADBAND_US：高电平宽度变化小于该值时不通知（方向盘静止），
+ *   按捕获计数频率换算成 tick
+ * - GONIO_NODATA_MS：没有角度时线程的等待时间，也是无数据提示的间隔
+ */
+#define GONIO_NOTIFY_DECIMATE					4U
+#define GONIO_NOTIFY_DEADBAND_US			2U
+#define GONIO_NODATA_MS								1000U
+
+/* 角度单位：cdeg（百分之一度） */
+#define GONIO_CDEG_180				18000
+#define GONIO_CDEG_360				36000
+
+/**
+ * @brief 角度滤波级（编译期配置，均为整数运算）
+ * @note
+ * - GONIO_FILTER_MEDIAN_N：滑动中值窗口长度，<=1 关闭；单个毛刺样本在
+ *   N>=3 时不会进入阈值判断，也就不会打断稳态计时
+ * - GONIO_FILTER_IIR_SHIFT：一阶 IIR 系数 1/2^shift，0 关闭
+ */
+#ifndef GONIO_FILTER_MEDIAN_N
+#define GONIO_FILTER_MEDIAN_N					5U
+#endif
+#ifndef GONIO_FILTER_IIR_SHIFT
+#define GONIO_FILTER_IIR_SHIFT				0
+#endif
+
+// clang-format on
+
+/**
+ * @brief 转向判定参数
+ * @note 角度单位 cdeg，时间单位 ms；判定按时间戳计时，与采样率无关
+ */
+typedef struct
+{
+  s32 turn_on_cdeg; /* 转向阈值（绝对值） */
+  s32 center_cdeg;  /* 回正阈值（绝对值） */
+  s32 hyst_cdeg;    /* 滞回：候选状态计时期间阈值放宽的量 */
+  u32 turn_ms;      /* CENTER -> LEFT/RIGHT 需保持的时间 */
+  u32 center_ms;    /* LEFT/RIGHT -> CENTER 需保持的时间 */
+  u32 hold_ms;      /* 无捕获超过该时间视为信号丢失 */
+  u32 predict_ms;   /* 预测条件需保持的时间 */
+  u32 confirm_ms;   /* 预测提交后须确认的时间 */
+} app_gonio_param_t;
+
+/**
+ * @brief 多圈展开状态
+ * @note
+ * 把逐次的绝对角度 [0, 36000) 展开成连续角度 base_abs + acc，方向盘转过
+ * ±180° 以外（满舵约 ±1.5 圈）时不会折回。每次捕获都要调用，
+ * 由捕获路径（中断或 DMA 窗口）单独持有，与 app_gonio_core_t 分开。
+ */
+typedef struct
+{
+  s32 prev_abs;   /* 上一次接受的绝对角度，-1 表示尚未初始化 */
+  s32 base_abs;   /* 第一次接受的绝对角度 */
+  s32 acc;        /* 自 base_abs 起累加的角度（可超过 ±36000） */
+  u32 prev_us;    /* 上一次接受的读数的时间戳 */
+  u32 reject_run; /* 连续拒绝次数 */
+  u32 rejects;    /* 累计拒绝次数 */
+} app_gonio_unwrap_t;
+
+/**
+ * @brief SPI 绝对编码器读回帧的检查结果
+ */
+typedef enum
+{
+  GONIO_SPI_FRAME_OK = 0, /* 有效 */
+  GONIO_SPI_FRAME_PARITY, /* 偶校验错误（线路干扰） */
+  GONIO_SPI_FRAME_EF,     /* 错误标志置位（上一条命令出错） */
+  GONIO_SPI_FRAME_REJECT, /* 帧有效，但跳变过大被多圈展开拒绝 */
+} app_gonio_spi_frame_t;
+
+/**
+ * @brief 核心状态（滤波器、角速度与状态机），每个实例互不影响
+ */
+typedef struct
+{
+#if GONIO_FILTER_MEDIAN_N > 1
+  s32 med_hist[GONIO_FILTER_MEDIAN_N];   /* 按到达顺序（环形） */
+  s32 med_sorted[GONIO_FILTER_MEDIAN_N]; /* 升序 */
+  u32 med_head;
+  u32 med_count;
+#endif
+#if GONIO_FILTER_IIR_SHIFT > 0
+  s32 iir_acc; /* 放大 2^shift 保存 */
+  bool iir_inited;
+#endif
+
+  s32 vel; /* 角速度（单位：cdeg/s，左转方向为正） */
+  s32 vel_prev_cdeg;
+  u32 vel_prev_us;
+  bool vel_inited;
+
+  app_steer_state_t state; /* 已提交的状态 */
+  app_steer_state_t cand;  /* 候选状态 */
+  u32 cand_since_ms;       /* 候选状态开始满足条件的时刻 */
+  u32 cand_dwell_ms;       /* 候选状态需要保持的时间 */
+  bool predicted;          /* 当前 LEFT/RIGHT 由预测提前提交、尚未确认 */
+  u32 predicted_since_ms;
+} app_gonio_core_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 将角度差限制到 [-18000, +18000]（单位：cdeg）
+ * @note
+ * 只要传感器角度存在 0°/360° 回绕，就建议做这个处理。
+ * 入参来自两个 [0, 36000) 的绝对角度之差，范围在 (-36000, 36000) 内，
+ * 因此各修正一次即可，不需要循环。
+ */
+static inline s32 app_gonio_core_wrap_180(s32 delta_cdeg)
+{
+  if (delta_cdeg > GONIO_CDEG_180)
+    delta_cdeg -= GONIO_CDEG_360;
+  else if (delta_cdeg < -GONIO_CDEG_180)
+    delta_cdeg += GONIO_CDEG_360;
+  return delta_cdeg;
+}
+
+/**
+ * @brief 多圈展开：复位（下一次读数作为新的起点）
+ */
+void app_gonio_core_unwrap_init(app_gonio_unwrap_t *u);
+
+/**
+ * @brief 多圈展开：输入一次绝对角度
+ *
+ * @param abs_cdeg 绝对角度 [0, 36000)，小于 0 表示本次捕获无效
+ * @param t_us 本次读数的时间戳（单位：us，允许回绕）
+ * @return 本次读数是否被接受（无效或跳变过大时返回 false，累加值不变）
+ */
+bool app_gonio_core_unwrap(app_gonio_unwrap_t *u, s32 abs_cdeg, u32 t_us);
+
+/**
+ * @brief 解码一帧 SPI 绝对编码器数据（AS5048A/AS5047 帧格式）
+ *
+ * @param frame 读回的 16 位帧：bit15 偶校验，bit14 错误标志，bit13:0 角度
+ * @param invert true：方向取反
+ * @param out_abs 输出绝对角度 [0, 36000)，仅在返回 GONIO_SPI_FRAME_OK 时有效
+ * @return 帧检查结果
+ */
+app_gonio_spi_frame_t app_gonio_core_spi_frame(u16 frame, bool invert,
+                                               s32 *out_abs);
+
+/**
+ * @brief 处理一帧 SPI 读数：帧检查后送入多圈展开
+ *
+ * @param u 多圈展开状态
+ * @param frame 读回的 16 位帧
+ * @param invert true：方向取反
+ * @param t_us 本帧的时间戳（单位：us）
+ * @param out_abs 输出绝对角度，仅在返回 GONIO_SPI_FRAME_OK 时有效
+ * @return 帧检查结果，GONIO_SPI_FRAME_OK 表示已计入 u->acc
+ */
+app_gonio_spi_frame_t app_gonio_core_spi_sample(app_gonio_unwrap_t *u,
+                                                u16 frame, bool invert,
+                                                u32 t_us, s32 *out_abs);
+
+/**
+ * @brief 连续角度换算成相对 0 点的多圈角度
+ *
+ * @param base_abs 展开起点（app_gonio_unwrap_t.base_abs）
+ * @param acc 展开累加值（app_gonio_unwrap_t.acc）
+ * @param zero_cdeg 0 点绝对角度
+ * @return 相对角度（单位：cdeg，可超过 ±18000）
+ * @note 起点按离 0 点最近的一圈对齐，即假定上电时方向盘在 0 点 ±180° 内
+ */
+static inline s32 app_gonio_core_unwrap_rel(s32 base_abs, s32 acc,
+                                            s32 zero_cdeg)
+{
+  return app_gonio_core_wrap_180(base_abs - zero_cdeg) + acc;
+}
+
+/**
+ * @brief 初始化核心状态（状态机回到 CENTER）
+ */
+void app_gonio_core_init(app_gonio_core_t *c);
+
+/**
+ * @brief 由一次捕获值解码绝对角度（单位：cdeg）
+ *
+ * @param period 周期（定时器 tick，可为溢出扩展后的 32 位值）
+ * @param high 高电平宽度（定时器 tick）
+ * @param use_low true：按低电平宽度解码
+ * @return 绝对角度 [0, 36000)，-1 表示本次捕获无效
+ */
+s32 app_gonio_core_decode(u32 period, u32 high, bool use_low);
+
+/**
+ * @brief 角度滤波：中值（去毛刺）-> IIR（平滑）
+ *
+ * @param rel_cdeg 未滤波的相对角度
+ * @return 滤波后的相对角度
+ */
+s32 app_gonio_core_filter(app_gonio_core_t *c, s32 rel_cdeg);
+
+/**
+ * @brief 用一次新角度更新角速度估计
+ *
+ * @param rel_cdeg 滤波后的相对角度
+ * @param t_us 该角度对应的捕获时间戳（单位：us，只用于求差值）
+ */
+void app_gonio_core_velocity(app_gonio_core_t *c, s32 rel_cdeg, u32 t_us);
+
+/**
+ * @brief 信号丢失或 0 点变化：清空滤波器、角速度，并放弃正在计时的候选状态
+ * @note 已提交的状态保持不变
+ */
+void app_gonio_core_reset(app_gonio_core_t *c);
+
+/**
+ * @brief 转向状态机走一步
+ *
+ * @param p 判定参数
+ * @param angle 当前（滤波后）相对角度
+ * @param now_ms 当前时刻（单位：ms，只用于求差值）
+ * @return 本次是否提交了新的状态（新状态见 c->state，预测提交时 c->predicted 为 true）
+ */
+bool app_gonio_core_step(app_gonio_core_t *c, const app_gonio_param_t *p,
+                         s32 angle, u32 now_ms);
+
+/**
+ * @brief 距离状态机下一次需要检查还需等待的时间
+ *
+ * @param p 判定参数
+ * @param idle_ms 没有候选状态、也没有待确认的预测时返回的值（上限）
+ * @return 单位 ms，取候选状态到期与预测确认时限中较早者
+ * @note 只在有角度时使用；信号丢失后核心被复位，调用者按 idle_ms 等待
+ */
+u32 app_gonio_core_wait_ms(const app_gonio_core_t *c, const app_gonio_param_t *p,
+                           u32 now_ms, u32 idle_ms);
+
+#endif
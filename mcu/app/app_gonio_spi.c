@@ -0,0 +1,293 @@
+/**
+ * @file		app_gonio_spi.c
+ * @brief		用于定义操作该模块的函数
+ * @note		角度测量模块的 SPI 绝对编码器角度源（AS5048A/AS5047）
+ * @author	王广平
+ *
+ * @note
+ * 1) 传感器每帧返回上一条命令的结果，这里始终发同一条读角度命令，
+ *    因此每帧都是一次有效读数（滞后一个读取周期）。
+ * 2) 取帧、片选都由 TIM4 触发的 DMA 完成，读取速率固定，不受 PWM 频率限制，
+ *    也没有输入捕获的抖动；线程每次唤醒处理整批帧，逐帧校验并做多圈展开，
+ *    角度取窗口内连续角度的平均值。
+ * 3) 校验错误或错误标志置位的帧直接丢弃并计数（"gonio show" 可查看）。
+ */
+
+#define __APP_GONIO_SPI_C
+
+/* 头文件引用 */
+#include "app_gonio_spi.h"
+#include "app_gonio_core.h"
+#include "bsp_dma.h"
+#include "bsp_gpio.h"
+#include "bsp_spi.h"
+#include "bsp_timer.h"
+#include "system_boot.h"
+#include "stm32f1xx_hal_cortex.h"
+#include "stm32f1xx_hal_gpio.h"
+#include "stm32f1xx_hal_spi.h"
+#include "stm32f1xx_hal_tim.h"
+#include <stdio.h>
+
+/* ============================== 静态全局变量 ============================== */
+static SPI_HandleTypeDef GONIO_SPI_HANDLE = {0};
+static TIM_HandleTypeDef GONIO_SPI_TIM = {0};
+static DMA_HandleTypeDef GONIO_SPI_RX = {0};
+static DMA_HandleTypeDef GONIO_SPI_CS_LOW = {0};
+static DMA_HandleTypeDef GONIO_SPI_CMD = {0};
+static DMA_HandleTypeDef GONIO_SPI_CS_HIGH = {0};
+static bool gonio_spi_ready = false;
+
+/* 由定时器请求搬运到外设寄存器的固定值 */
+static const u32 gonio_spi_cs_low = BSP_GPIO_BSRR(0, GONIO_SPI_CS_PIN);
+static const u32 gonio_spi_cs_high = BSP_GPIO_BSRR(GONIO_SPI_CS_PIN, 0);
+static const u32 gonio_spi_cmd = GONIO_SPI_CMD_ANGLE;
+
+/* 接收环形缓冲区与线程侧读指针（单位：帧） */
+static u16 gonio_spi_ring[GONIO_SPI_RING_FRAMES];
+static u32 gonio_spi_rd = 0;
+/* 半传输/传输完成中断计数，以及线程上次读取时的值，用于检测环形缓冲区被追上 */
+static volatile u32 gonio_spi_halves = 0;
+static u32 gonio_spi_halves_seen = 0;
+
+/**
+ * @brief 多圈展开状态（只在角度线程中访问）
+ * @note 方向与重新展开请求由 resync 在任意线程写入，线程取样时处理，
+ * 与 PWM 角度源的 req/ack 做法相同。
+ */
+static app_gonio_unwrap_t gonio_spi_unwrap = {.prev_abs = -1};
+static volatile bool gonio_spi_invert = false;
+static volatile u32 gonio_spi_unwrap_req = 0;
+static u32 gonio_spi_unwrap_ack = 0;
+
+/* 帧计数（只在角度线程中更新） */
+static app_gonio_spi_stats_t gonio_spi_stats = {0};
+
+/* 采样时间戳（单位：us），按帧数与固定读取周期推算 */
+#define GONIO_SPI_PERIOD_US (1000000UL / GONIO_SPI_RATE_HZ)
+static u32 gonio_spi_t_us = 0;
+
+/* ============================== 中断 ============================== */
+/**
+ * @brief 接收 DMA 半传输/传输完成回调：每半个环形缓冲区唤醒一次线程
+ */
+static void app_gonio_spi_rx_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  gonio_spi_halves++;
+  app_gonio_NotifyFromISR();
+}
+
+/* ============================== 角度源接口 ============================== */
+/**
+ * @brief 计算 DMA 当前写指针（单位：帧）
+ */
+static inline u32 app_gonio_spi_wr(void)
+{
+  u32 left = __HAL_DMA_GET_COUNTER(&GONIO_SPI_RX);
+  return (GONIO_SPI_RING_FRAMES - left) % GONIO_SPI_RING_FRAMES;
+}
+
+static bool app_gonio_spi_pending(void)
+{
+  return gonio_spi_ready && gonio_spi_rd != app_gonio_spi_wr();
+}
+
+static bool app_gonio_spi_read(app_gonio_sample_t *out)
+{
+  if (!gonio_spi_ready)
+    return false;
+
+  u32 wr = app_gonio_spi_wr();
+  u32 halves = gonio_spi_halves;
+  u32 req = gonio_spi_unwrap_req;
+  bool invert = gonio_spi_invert;
+  s32 last = -1;
+  s32 sum = 0;
+  s32 n = 0;
+
+  if (req != gonio_spi_unwrap_ack)
+  {
+    gonio_spi_unwrap_ack = req;
+    app_gonio_core_unwrap_init(&gonio_spi_unwrap);
+  }
+
+  /* 与 PWM 的 DMA 模式相同：经过 3 个及以上半缓冲区说明写端追上了读端 */
+  u32 passed = halves - gonio_spi_halves_seen;
+  gonio_spi_halves_seen = halves;
+  if (passed > 2U)
+  {
+    u32 lost = (passed - 2U) * (GONIO_SPI_RING_FRAMES / 2U);
+    gonio_spi_stats.dropped += lost;
+    gonio_spi_t_us += lost * GONIO_SPI_PERIOD_US;
+    gonio_spi_rd = wr;
+  }
+
+  while (gonio_spi_rd != wr)
+  {
+    u16 frame = gonio_spi_ring[gonio_spi_rd];
+    s32 a = -1;
+
+    gonio_spi_rd = (gonio_spi_rd + 1U) % GONIO_SPI_RING_FRAMES;
+    gonio_spi_t_us += GONIO_SPI_PERIOD_US;
+    gonio_spi_stats.frames++;
+
+    switch (app_gonio_core_spi_sample(&gonio_spi_unwrap, frame, invert,
+                                      gonio_spi_t_us, &a))
+    {
+    case GONIO_SPI_FRAME_OK:
+      break;
+    case GONIO_SPI_FRAME_PARITY:
+      gonio_spi_stats.err_parity++;
+      continue;
+    case GONIO_SPI_FRAME_EF:
+      gonio_spi_stats.err_flag++;
+      continue;
+    default: /* 展开拒绝，计入 unwrap.rejects */
+      continue;
+    }
+
+    last = a;
+    sum += gonio_spi_unwrap.acc;
+    n++;
+  }
+
+  if (n == 0)
+    return false;
+
+  out->abs_cdeg = last;
+  out->unwrap_base = gonio_spi_unwrap.base_abs;
+  out->unwrap_acc = sum / n;
+  out->t_us = gonio_spi_t_us;
+  return true;
+}
+
+static void app_gonio_spi_resync(bool invert)
+{
+  gonio_spi_invert = invert;
+  gonio_spi_unwrap_req++;
+}
+
+static void app_gonio_spi_show(void)
+{
+  printf("[GONIO] frames=%lu, parity=%lu, ef=%lu, dropped=%lu, "
+         "unwrap_rej=%lu, rate=%luHz\r\n",
+         (unsigned long)gonio_spi_stats.frames,
+         (unsigned long)gonio_spi_stats.err_parity,
+         (unsigned long)gonio_spi_stats.err_flag,
+         (unsigned long)gonio_spi_stats.dropped,
+         (unsigned long)gonio_spi_unwrap.rejects,
+         (unsigned long)GONIO_SPI_RATE_HZ);
+}
+
+/**
+ * @brief 启动一路“定时器请求 -> 写外设寄存器”的 DMA
+ */
+static RESULT_Init app_gonio_spi_reg_dma(DMA_HandleTypeDef *hdma,
+                                         DMA_Channel_TypeDef *channel,
+                                         const u32 *src, u32 dst_addr)
+{
+  DMA_Init_Config cfg = bsp_dma_conf_regWrite(channel);
+  if (bsp_dma_init(hdma, &cfg) != ERR_Init_Finished)
+    return ERR_Init_ERROR_DMA;
+  if (HAL_DMA_Start(hdma, (u32)src, dst_addr, 1) != HAL_OK)
+    return ERR_Init_ERROR_DMA;
+  return ERR_Init_Finished;
+}
+
+static RESULT_Init app_gonio_spi_init(void)
+{
+  RESULT_Init ret = ERR_Init_Start;
+
+  /* 初始化GPIO引脚：SCK/MOSI 复用推挽，MISO 浮空输入，片选默认拉高 */
+  bsp_gpio_AFPP_Init(GONIO_SPI_GPIOx, GONIO_SPI_SCK_PIN | GONIO_SPI_MOSI_PIN);
+  bsp_gpio_Init(GONIO_SPI_GPIOx, GONIO_SPI_MISO_PIN, GPIO_MODE_AF_INPUT,
+                GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH);
+  bsp_gpio_OTPP_Init(GONIO_SPI_GPIOx, GONIO_SPI_CS_PIN);
+  bsp_gpio_WriteMask(GONIO_SPI_GPIOx, GONIO_SPI_CS_PIN, 0);
+
+  /* SPI2：16 位帧，模式 1（CPOL=0，CPHA=1），36MHz/4 = 9MHz */
+  ret = bsp_spi_Init(&GONIO_SPI_HANDLE, GONIO_SPI, SPI_MODE_MASTER,
+                     SPI_DIRECTION_2LINES, SPI_DATASIZE_16BIT, SPI_POLARITY_LOW,
+                     SPI_PHASE_2EDGE, SPI_NSS_SOFT, SPI_BAUDRATEPRESCALER_4,
+                     SPI_FIRSTBIT_MSB, SPI_TIMODE_DISABLE,
+                     SPI_CRCCALCULATION_DISABLE, 0);
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  /* 接收 DMA：SPI2->DR -> 环形缓冲区 */
+  DMA_Init_Config rx_cfg = bsp_dma_conf_spiRX(GONIO_SPI_DMA_RX);
+  if (bsp_dma_init(&GONIO_SPI_RX, &rx_cfg) != ERR_Init_Finished)
+    return ERR_Init_ERROR_DMA;
+  GONIO_SPI_RX.XferHalfCpltCallback = app_gonio_spi_rx_cb;
+  GONIO_SPI_RX.XferCpltCallback = app_gonio_spi_rx_cb;
+  if (HAL_DMA_Start_IT(&GONIO_SPI_RX, (u32)&GONIO_SPI->DR,
+                       (u32)gonio_spi_ring, GONIO_SPI_RING_FRAMES) != HAL_OK)
+    return ERR_Init_ERROR_DMA;
+  HAL_NVIC_SetPriority(GONIO_SPI_DMA_RX_IRQn, GONIO_SPI_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(GONIO_SPI_DMA_RX_IRQn);
+
+  SET_BIT(GONIO_SPI->CR2, SPI_CR2_RXDMAEN);
+  __HAL_SPI_ENABLE(&GONIO_SPI_HANDLE);
+
+  /* 片选与命令：三路定时器请求各自循环写同一个寄存器 */
+  ret = app_gonio_spi_reg_dma(&GONIO_SPI_CS_LOW, GONIO_SPI_DMA_CS_LOW,
+                              &gonio_spi_cs_low, (u32)&GONIO_SPI_GPIOx->BSRR);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  ret = app_gonio_spi_reg_dma(&GONIO_SPI_CMD, GONIO_SPI_DMA_CMD, &gonio_spi_cmd,
+                              (u32)&GONIO_SPI->DR);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  ret = app_gonio_spi_reg_dma(&GONIO_SPI_CS_HIGH, GONIO_SPI_DMA_CS_HIGH,
+                              &gonio_spi_cs_high,
+                              (u32)&GONIO_SPI_GPIOx->BSRR);
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  /* TIM4：72MHz/72 = 1MHz，周期 1/GONIO_SPI_RATE_HZ */
+  bsp_timer_SetStruct(&GONIO_SPI_TIM, GONIO_SPI_TIMx,
+                      (SYSTEM_BOOT_APB1_TIMER_HZ / 1000000UL) - 1UL,
+                      TIM_COUNTERMODE_UP, GONIO_SPI_PERIOD_US - 1UL,
+                      TIM_CLOCKDIVISION_DIV1, TIM_AUTORELOAD_PRELOAD_DISABLE,
+                      0);
+  if (HAL_TIM_Base_Init(&GONIO_SPI_TIM) != HAL_OK)
+    return ERR_Init_ERROR_TIM;
+
+  /* 比较通道保持冻结模式，只用比较匹配产生 DMA 请求，不驱动引脚 */
+  __HAL_TIM_SET_COMPARE(&GONIO_SPI_TIM, TIM_CHANNEL_1, GONIO_SPI_CS_LEAD_US);
+  __HAL_TIM_SET_COMPARE(&GONIO_SPI_TIM, TIM_CHANNEL_3,
+                        GONIO_SPI_CS_LEAD_US + GONIO_SPI_CS_HOLD_US);
+  __HAL_TIM_ENABLE_DMA(&GONIO_SPI_TIM, TIM_DMA_UPDATE | TIM_DMA_CC1 |
+                                           TIM_DMA_CC3);
+
+  gonio_spi_ready = true;
+  __HAL_TIM_ENABLE(&GONIO_SPI_TIM);
+
+  ret = ERR_Init_Finished;
+  return ret;
+}
+
+const app_gonio_source_t app_gonio_source_spi = {
+    .name = "spi",
+    .hint = "SPI 编码器无有效帧，请检查：PB12~PB15(SPI2)接线/供电/磁铁距离，"
+            "\"gonio show\" 查看校验错误计数",
+    .init = app_gonio_spi_init,
+    .read = app_gonio_spi_read,
+    .pending = app_gonio_spi_pending,
+    .resync = app_gonio_spi_resync,
+    .show = app_gonio_spi_show,
+};
+
+/* ============================== 查询 ============================== */
+void app_gonio_spi_GetStats(app_gonio_spi_stats_t *out)
+{
+  if (out == NULL)
+    return;
+  *out = gonio_spi_stats;
+}
+
+DMA_HandleTypeDef *app_gonio_spi_getDMAHandle()
+{
+  return gonio_spi_ready ? &GONIO_SPI_RX : NULL;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file		app_gonio_spi.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		角度测量模块的 SPI 绝对编码器角度源（AS5048A/AS5047）
+ * @author	王广平
+ **/
+
+#ifndef __APP_GONIO_SPI_H
+#define __APP_GONIO_SPI_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+#include "app_gonio.h"
+#include "stm32f1xx_hal_dma.h"
+
+/* 宏定义 */
+// clang-format off
+
+#ifdef __APP_GONIO_SPI_C	/* 用于.c文件的宏 */
+
+#define GONIO_SPI						SPI2					/* 指定SPI */
+#define GONIO_SPI_GPIOx			GPIOB					/* 指定GPIO分组 */
+#define GONIO_SPI_CS_PIN		GPIO_PIN_12		/* 片选 */
+#define GONIO_SPI_SCK_PIN		GPIO_PIN_13
+#define GONIO_SPI_MISO_PIN	GPIO_PIN_14
+#define GONIO_SPI_MOSI_PIN	GPIO_PIN_15
+
+/**
+ * @brief 定速读取参数
+ * @note
+ * TIM4 以 1MHz 计数，每个周期由三个 DMA 请求完成一帧，全程不进中断：
+ * - 更新事件：写 BSRR 拉低片选
+ * - CC1（GONIO_SPI_CS_LEAD_US）：写 SPI2->DR 发出读角度命令
+ * - CC3（再过 GONIO_SPI_CS_HOLD_US）：写 BSRR 拉高片选
+ * 读回的帧由 SPI2_RX DMA 写入环形缓冲区，半满/满时唤醒角度线程。
+ * SPI 时钟 36MHz/4 = 9MHz，一帧约 1.8us。
+ */
+#define GONIO_SPI_TIMx					TIM4
+#define GONIO_SPI_RATE_HZ				2000UL	/* 读取速率 */
+#define GONIO_SPI_CS_LEAD_US		2U			/* 片选拉低到发出命令 */
+#define GONIO_SPI_CS_HOLD_US		6U			/* 发出命令到片选拉高 */
+#define GONIO_SPI_RING_FRAMES		16U			/* 接收环形缓冲区帧数 */
+#define GONIO_SPI_IRQ_PRIORITY	5				/* 不小于 configMAX_SYSCALL_INTERRUPT_PRIORITY */
+
+#define GONIO_SPI_DMA_RX				DMA1_Channel4	/* SPI2_RX */
+#define GONIO_SPI_DMA_RX_IRQn		DMA1_Channel4_IRQn
+#define GONIO_SPI_DMA_CS_LOW		DMA1_Channel7	/* TIM4_UP */
+#define GONIO_SPI_DMA_CMD				DMA1_Channel1	/* TIM4_CH1 */
+#define GONIO_SPI_DMA_CS_HIGH		DMA1_Channel5	/* TIM4_CH3 */
+
+/* 读角度寄存器 0x3FFF：bit14 读标志 + bit15 偶校验 */
+#define GONIO_SPI_CMD_ANGLE			0xFFFFU
+
+#endif
+// clang-format on
+
+/* SPI 角度源的帧计数 */
+typedef struct
+{
+  u32 frames;     /* 读回的帧数 */
+  u32 err_parity; /* 偶校验错误 */
+  u32 err_flag;   /* 传感器错误标志 */
+  u32 dropped;    /* 环形缓冲区被追上而丢弃的帧数（按半缓冲区估计的下限） */
+} app_gonio_spi_stats_t;
+
+/* SPI 角度源 */
+extern const app_gonio_source_t app_gonio_source_spi;
+
+/* 函数声明 */
+
+/**
+ * @brief 获取 SPI 角度源的帧计数
+ *
+ * @param out 输出计数
+ * @note 在角度线程以外调用时各字段可能不是同一时刻的值，只用于诊断
+ */
+void app_gonio_spi_GetStats(app_gonio_spi_stats_t *out);
+
+/**
+ * @brief 获取接收 DMA 句柄
+ *
+ * @return SPI2_RX 所用 DMA 句柄，未选用 SPI 角度源时为 NULL
+ */
+DMA_HandleTypeDef *app_gonio_spi_getDMAHandle();
+
+#endif
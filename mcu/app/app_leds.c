@@ -0,0 +1,190 @@
+/**
+ * @file		app_leds.c
+ * @brief		用于定义操作该模块的函数
+ * @note		氛围灯带模块（WS2812 类可寻址 LED）
+ * @author	王广平
+ *
+ * @note
+ * 1) 帧缓冲区按 GRB 保存颜色，app_leds_show() 只负责启动发送。
+ * 2) 位波形由 TIM1 PWM 输出，DMA 循环播放两个半缓冲区，每个半缓冲区一块
+ *    （LEDS_CHUNK_LEDS 颗灯珠）；播放完一半就在中断里编码下一块，
+ *    每字节先经 app_lut 查表（gamma 与亮度）再编码，编码与分块调度见 app_leds_wave.c。
+ * 3) 数据发完后再播放至少 LEDS_RESET_US 的全零块作为复位间隔，然后关闭
+ *    DMA 请求，CCR1 保持 0，输出保持低电平。
+ */
+
+#define __APP_LEDS_C
+
+/* 头文件引用 */
+#include "app_leds.h"
+#include "app_lut.h"
+#include "bsp_dma.h"
+#include "bsp_gpio.h"
+#include "bsp_timer.h"
+#include "stm32f1xx_hal_cortex.h"
+#include "stm32f1xx_hal_gpio.h"
+#include "stm32f1xx_hal_tim.h"
+#include "system_boot.h"
+#include <string.h>
+
+/* 位波形按 LEDS_TIM_HZ 计算比较值，须与 TIM1 的实际计数频率一致 */
+#if LEDS_TIM_HZ != SYSTEM_BOOT_APB2_HZ
+#error "LEDS_TIM_HZ must match SYSTEM_BOOT_APB2_HZ"
+#endif
+
+/* 定时器与 DMA 句柄 */
+static TIM_HandleTypeDef APP_LEDS_TIM = {0};
+static DMA_HandleTypeDef APP_LEDS_DMA = {0};
+static bool leds_ready = false;
+
+/* 帧缓冲区（GRB，感知线性） */
+static u8 leds_frame[APP_LEDS_COUNT * 3U];
+
+/* 编码时使用的查找表（gamma 与亮度），发送开始时锁存到 leds_wave */
+static const u8 *leds_lut_next = NULL;
+
+/* DMA 双缓冲：两块位波形，按字访问以便查表写入 */
+static u32 leds_dma[2][LEDS_CHUNK_WORDS];
+
+/* 发送状态（中断与调用者共享） */
+static volatile bool leds_busy = false;
+static app_leds_wave_t leds_wave = {0};
+
+/**
+ * @brief 停止发送，输出保持低电平
+ */
+static void app_leds_stop()
+{
+  __HAL_TIM_DISABLE_DMA(&APP_LEDS_TIM, TIM_DMA_UPDATE);
+  (void)HAL_DMA_Abort(&APP_LEDS_DMA);
+  __HAL_TIM_SET_COMPARE(&APP_LEDS_TIM, LEDS_TIM_CHANNEL, 0);
+  leds_busy = false;
+}
+
+/**
+ * @brief 一块播放完：发完复位间隔则停止，否则编码下一块
+ */
+static void app_leds_chunk_done(u32 half)
+{
+  if (!app_leds_wave_chunk_done(&leds_wave, leds_dma[half]))
+    app_leds_stop();
+}
+
+static void app_leds_half_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  app_leds_chunk_done(0);
+}
+
+static void app_leds_full_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  app_leds_chunk_done(1);
+}
+
+static void app_leds_error_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  app_leds_stop();
+}
+
+RESULT_Init app_leds_init()
+{
+  RESULT_Init ret = ERR_Init_Start;
+
+  memset(leds_frame, 0, sizeof(leds_frame));
+  leds_lut_next = app_lut_row(255);
+
+  /* 数据输出引脚（TIM1_CH1/PA8） */
+  bsp_gpio_AFPP_Init(LEDS_GPIOx, LEDS_PIN);
+
+  /* TIM1：72MHz 计数，一个周期一位，CCR1 初始为 0（低电平） */
+  bsp_timer_SetStruct(&APP_LEDS_TIM, LEDS_TIMx, 0, TIM_COUNTERMODE_UP,
+                      LEDS_BIT_TICKS - 1UL, TIM_CLOCKDIVISION_DIV1,
+                      TIM_AUTORELOAD_PRELOAD_DISABLE, 0);
+  ret = bsp_timer_PWM_init(&APP_LEDS_TIM, TIM_OCMODE_PWM1, 0,
+                           TIM_OCPOLARITY_HIGH, TIM_OCFAST_DISABLE,
+                           TIM_OCIDLESTATE_RESET, TIM_OCNIDLESTATE_RESET,
+                           TIM_OCNPOLARITY_HIGH, LEDS_TIM_CHANNEL);
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  /* DMA：字节读出、半字写入 CCR1，循环模式，半传输/传输完成时编码下一块 */
+  DMA_Init_Config dma_cfg = bsp_dma_conf_PWMwave(LEDS_DMA_CHANNEL);
+  ret = bsp_dma_init(&APP_LEDS_DMA, &dma_cfg);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  APP_LEDS_DMA.XferHalfCpltCallback = app_leds_half_cb;
+  APP_LEDS_DMA.XferCpltCallback = app_leds_full_cb;
+  APP_LEDS_DMA.XferErrorCallback = app_leds_error_cb;
+
+  HAL_NVIC_SetPriority(LEDS_DMA_IRQn, LEDS_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(LEDS_DMA_IRQn);
+
+  leds_ready = true;
+  ret = ERR_Init_Finished;
+  return ret;
+}
+
+RESULT_RUN app_leds_set(u16 index, u8 r, u8 g, u8 b)
+{
+  if (index >= APP_LEDS_COUNT)
+    return ERR_RUN_ERROR_ERIP;
+
+  u8 *p = &leds_frame[index * 3U];
+  p[0] = g;
+  p[1] = r;
+  p[2] = b;
+  return ERR_RUN_Finished;
+}
+
+RESULT_RUN app_leds_fill(u16 first, u16 count, u8 r, u8 g, u8 b)
+{
+  if ((u32)first + count > APP_LEDS_COUNT)
+    return ERR_RUN_ERROR_ERIP;
+
+  u8 *p = &leds_frame[first * 3U];
+  for (u16 i = 0; i < count; i++)
+  {
+    *p++ = g;
+    *p++ = r;
+    *p++ = b;
+  }
+  return ERR_RUN_Finished;
+}
+
+RESULT_RUN app_leds_set_brightness(u8 level)
+{
+  leds_lut_next = app_lut_row(level);
+  return ERR_RUN_Finished;
+}
+
+u8 *app_leds_getFrame() { return leds_frame; }
+
+bool app_leds_busy() { return leds_busy; }
+
+RESULT_RUN app_leds_show()
+{
+  if (!leds_ready)
+    return ERR_RUN_ERROR_UNST;
+  if (leds_busy)
+    return ERR_RUN_BUSY;
+
+  leds_busy = true;
+  app_leds_wave_start(&leds_wave, leds_frame, APP_LEDS_COUNT, leds_lut_next,
+                      leds_dma[0], leds_dma[1]);
+
+  if (HAL_DMA_Start_IT(&APP_LEDS_DMA, (u32)leds_dma,
+                       (u32)&LEDS_TIMx->CCR1, sizeof(leds_dma)) != HAL_OK)
+  {
+    leds_busy = false;
+    return ERR_RUN_ERROR_CALL;
+  }
+  __HAL_TIM_ENABLE_DMA(&APP_LEDS_TIM, TIM_DMA_UPDATE);
+  return ERR_RUN_Finished;
+}
+
+DMA_HandleTypeDef *app_leds_getDMAHandle()
+{
+  return leds_ready ? &APP_LEDS_DMA : NULL;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file		app_leds.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		氛围灯带模块（WS2812 类可寻址 LED）
+ * @author	王广平
+ **/
+
+#ifndef __APP_LEDS_H
+#define __APP_LEDS_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+#include "app_leds_wave.h"
+#include "stm32f1xx_hal_dma.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+
+/**
+ * @brief 是否启用灯带
+ * @note
+ * 默认关闭：目前还没有模块调用 app_leds_show()，启用后上电即占用
+ * TIM1、PA8 与 DMA1_Channel5。灯带与 SPI 角度源（GONIO_SOURCE_SPI=1）
+ * 共用 DMA1_Channel5，二者只能选一。
+ */
+#ifndef APP_LEDS_ENABLE
+#define APP_LEDS_ENABLE 0
+#endif
+
+#define APP_LEDS_COUNT 240U /* 灯珠数量，帧缓冲区按 GRB 每颗 3 字节 */
+
+// clang-format off
+
+#ifdef __APP_LEDS_C	/* 用于.c文件的宏 */
+
+#define LEDS_PIN						GPIO_PIN_8		/* 数据输出：TIM1_CH1 */
+#define LEDS_GPIOx					GPIOA
+#define LEDS_TIMx						TIM1
+#define LEDS_TIM_CHANNEL		TIM_CHANNEL_1
+#define LEDS_DMA_CHANNEL		DMA1_Channel5	/* TIM1_UP */
+#define LEDS_DMA_IRQn				DMA1_Channel5_IRQn
+#define LEDS_IRQ_PRIORITY		5							/* 不小于 configMAX_SYSCALL_INTERRUPT_PRIORITY */
+
+/* 位波形与分块参数见 app_leds_wave.h；每个更新事件由 DMA 把下一位的比较值写入 CCR1 */
+
+#endif
+// clang-format on
+
+/* 函数声明 */
+
+/**
+ * @brief		初始化灯带
+ * @return	初始化结果
+ * @note		帧缓冲区清零，不发送
+ **/
+RESULT_Init app_leds_init();
+
+/**
+ * @brief		设置一颗灯珠的颜色
+ * @param		index	灯珠序号
+ * @param		r, g, b	颜色分量
+ * @return	运行结果
+ **/
+RESULT_RUN app_leds_set(u16 index, u8 r, u8 g, u8 b);
+
+/**
+ * @brief		把一段连续灯珠设置为同一颜色（一个灯区）
+ * @param		first	起始灯珠序号
+ * @param		count	灯珠数量
+ * @param		r, g, b	颜色分量
+ * @return	运行结果
+ **/
+RESULT_RUN app_leds_fill(u16 first, u16 count, u8 r, u8 g, u8 b);
+
+/**
+ * @brief		设置整条灯带的亮度
+ * @param		level	感知亮度，255 为不缩放（默认）
+ * @return	运行结果
+ * @note
+ * 帧缓冲区保存感知线性的颜色，编码时逐字节经 app_lut_row(level) 查表，
+ * 同时完成 gamma 校正与亮度缩放；下一次 app_leds_show() 生效
+ **/
+RESULT_RUN app_leds_set_brightness(u8 level);
+
+/**
+ * @brief		获取帧缓冲区
+ * @return	GRB 排列的帧缓冲区，共 APP_LEDS_COUNT * 3 字节
+ * @note		发送期间中断会边读边编码，只应在 app_leds_busy() 为 false 时改写
+ **/
+u8 *app_leds_getFrame();
+
+/**
+ * @brief		发送帧缓冲区
+ * @return	运行结果，上一帧未发送完时返回 ERR_RUN_BUSY
+ * @note		立即返回，发送由 DMA 完成，每半块进一次中断编码下一块
+ **/
+RESULT_RUN app_leds_show();
+
+/**
+ * @brief		是否正在发送
+ **/
+bool app_leds_busy();
+
+/**
+ * @brief		获取 DMA 句柄
+ * @return	TIM1_UP 所用 DMA 句柄，未初始化时为 NULL
+ **/
+DMA_HandleTypeDef *app_leds_getDMAHandle();
+
+#endif
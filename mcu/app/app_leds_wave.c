@@ -0,0 +1,81 @@
+/**
+ * @file		app_leds_wave.c
+ * @brief		用于定义操作该模块的函数
+ * @note		氛围灯带的位波形编码与分块调度
+ * @author	王广平
+ *
+ * @note
+ * 每字节先经查找表（gamma 与亮度），再用半字节查表编码，每字节两次 32 位写入。
+ */
+
+/* 头文件引用 */
+#include "app_leds_wave.h"
+#include <string.h>
+
+#if (LEDS_T1H_TICKS >= LEDS_BIT_TICKS) || (LEDS_BIT_TICKS > 256U)
+#error "LEDS_T1H_NS must fit in one bit and the bit period in one byte"
+#endif
+
+/* 一位对应的比较值，半字节查表：低地址字节先发 */
+#define LEDS_BIT(x) ((x) ? (u32)LEDS_T1H_TICKS : (u32)LEDS_T0H_TICKS)
+#define LEDS_NIBBLE(n)                                                         \
+  (LEDS_BIT((n) & 8U) | (LEDS_BIT((n) & 4U) << 8) |                            \
+   (LEDS_BIT((n) & 2U) << 16) | (LEDS_BIT((n) & 1U) << 24))
+
+static const u32 leds_nibble[16] = {
+    LEDS_NIBBLE(0U),  LEDS_NIBBLE(1U),  LEDS_NIBBLE(2U),  LEDS_NIBBLE(3U),
+    LEDS_NIBBLE(4U),  LEDS_NIBBLE(5U),  LEDS_NIBBLE(6U),  LEDS_NIBBLE(7U),
+    LEDS_NIBBLE(8U),  LEDS_NIBBLE(9U),  LEDS_NIBBLE(10U), LEDS_NIBBLE(11U),
+    LEDS_NIBBLE(12U), LEDS_NIBBLE(13U), LEDS_NIBBLE(14U), LEDS_NIBBLE(15U),
+};
+
+void app_leds_encode(const u8 *src, u32 bytes, const u8 *lut, u32 *out)
+{
+  for (u32 i = 0; i < bytes; i++)
+  {
+    u8 v = lut[src[i]];
+    *out++ = leds_nibble[v >> 4];
+    *out++ = leds_nibble[v & 0x0FU];
+  }
+}
+
+/**
+ * @brief 把下一块编码到指定的半缓冲区，超出灯珠数量的部分填 0
+ */
+static void app_leds_wave_fill(app_leds_wave_t *w, u32 *half)
+{
+  u32 chunk = w->next_chunk++;
+  u32 n = 0;
+
+  if (chunk < w->chunks)
+  {
+    u32 first = chunk * LEDS_CHUNK_LEDS;
+    n = w->leds - first;
+    if (n > LEDS_CHUNK_LEDS)
+      n = LEDS_CHUNK_LEDS;
+    app_leds_encode(&w->frame[first * 3U], n * 3U, w->lut, half);
+  }
+  memset((u8 *)half + n * 24U, 0, (LEDS_CHUNK_LEDS - n) * 24U);
+}
+
+void app_leds_wave_start(app_leds_wave_t *w, const u8 *frame, u32 leds,
+                         const u8 *lut, u32 *half0, u32 *half1)
+{
+  w->frame = frame;
+  w->lut = lut;
+  w->leds = leds;
+  w->chunks = (leds + LEDS_CHUNK_LEDS - 1U) / LEDS_CHUNK_LEDS;
+  w->next_chunk = 0;
+  w->played = 0;
+  app_leds_wave_fill(w, half0);
+  app_leds_wave_fill(w, half1);
+}
+
+bool app_leds_wave_chunk_done(app_leds_wave_t *w, u32 *half)
+{
+  w->played++;
+  if (w->played >= w->chunks + LEDS_RESET_CHUNKS)
+    return false;
+  app_leds_wave_fill(w, half);
+  return true;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file		app_leds_wave.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		氛围灯带的位波形编码与分块调度（与硬件无关，可在主机上编译测试）
+ * @author	王广平
+ *
+ * @note
+ * 每位对应 TIM1 的一个 PWM 周期，比较值由 DMA 逐位写入 CCR1；
+ * 本模块只负责把 GRB 字节编码为比较值，以及决定每个半缓冲区装哪一块，
+ * 定时器与 DMA 的配置在 app_leds.c。
+ **/
+
+#ifndef __APP_LEDS_WAVE_H
+#define __APP_LEDS_WAVE_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+#include <stdbool.h>
+
+/* 宏定义 */
+// clang-format off
+
+/**
+ * @brief 位波形
+ * @note
+ * TIM1 以 LEDS_TIM_HZ 计数，一个 PWM 周期就是一位（800kHz，1.25us）：
+ * - 0 码：高电平 LEDS_T0H_NS
+ * - 1 码：高电平 LEDS_T1H_NS
+ * - 比较值 0：整位低电平，用作复位间隔
+ * LEDS_TIM_HZ 须与 SYSTEM_BOOT_APB2_HZ 一致，app_leds.c 中编译期检查。
+ */
+#ifndef LEDS_TIM_HZ
+#define LEDS_TIM_HZ					72000000UL
+#endif
+#define LEDS_BIT_HZ					800000UL
+#define LEDS_T0H_NS					400U
+#define LEDS_T1H_NS					800U
+#define LEDS_RESET_US				300U			/* 帧间复位低电平（新款 WS2812B 需要 >280us） */
+
+/**
+ * @brief 分块编码
+ * @note
+ * DMA 循环搬运两个半缓冲区，每半个缓冲区是 LEDS_CHUNK_LEDS 颗灯珠的位波形
+ * （每位 1 字节，半字写入 CCR1 时高位补零）。半传输/传输完成中断里把刚播放完
+ * 的半个缓冲区编码成下一块，因此不需要整条灯带展开后的位波形缓冲区。
+ */
+#define LEDS_CHUNK_LEDS			8U
+
+// clang-format on
+
+/* 位周期与高电平时间（单位：定时器 tick） */
+#define LEDS_BIT_TICKS (LEDS_TIM_HZ / LEDS_BIT_HZ)
+#define LEDS_NS_TO_TICKS(ns)                                                   \
+  (((ns) * (LEDS_TIM_HZ / 1000000UL) + 500UL) / 1000UL)
+#define LEDS_T0H_TICKS LEDS_NS_TO_TICKS(LEDS_T0H_NS)
+#define LEDS_T1H_TICKS LEDS_NS_TO_TICKS(LEDS_T1H_NS)
+
+/* 分块：每块的位数与字数、每块播放时间、复位块数 */
+#define LEDS_CHUNK_BITS (LEDS_CHUNK_LEDS * 24U)
+#define LEDS_CHUNK_WORDS (LEDS_CHUNK_BITS / 4U)
+#define LEDS_CHUNK_US (LEDS_CHUNK_BITS * 1000000UL / LEDS_BIT_HZ)
+/* 复位块多留一块：DMA 读完一块时该块的最后一位还没有输出 */
+#define LEDS_RESET_CHUNKS                                                      \
+  ((LEDS_RESET_US + LEDS_CHUNK_US - 1UL) / LEDS_CHUNK_US + 1UL)
+
+/* 一次发送的分块调度状态 */
+typedef struct
+{
+  const u8 *frame; /* GRB 帧缓冲区 */
+  const u8 *lut;   /* 逐字节查找表（gamma 与亮度） */
+  u32 chunks;      /* 数据块数 */
+  u32 leds;        /* 灯珠数量 */
+  u32 next_chunk;  /* 下一块要编码的块序号 */
+  u32 played;      /* 已播放完的块数 */
+} app_leds_wave_t;
+
+/* 函数声明 */
+
+/**
+ * @brief		把字节查表后按位编码为比较值
+ * @param		src		源数据（GRB 字节）
+ * @param		bytes	字节数
+ * @param		lut		逐字节查找表（gamma 与亮度）
+ * @param		out		输出，每字节 8 个比较值（高位先发），共 bytes * 2 个字
+ **/
+void app_leds_encode(const u8 *src, u32 bytes, const u8 *lut, u32 *out);
+
+/**
+ * @brief		开始一次发送：编码前两块
+ * @param		w			调度状态
+ * @param		frame	GRB 帧缓冲区，发送期间不应改写
+ * @param		leds	灯珠数量
+ * @param		lut		逐字节查找表
+ * @param		half0, half1	两个半缓冲区，各 LEDS_CHUNK_WORDS 个字
+ **/
+void app_leds_wave_start(app_leds_wave_t *w, const u8 *frame, u32 leds,
+                         const u8 *lut, u32 *half0, u32 *half1);
+
+/**
+ * @brief		一个半缓冲区播放完：编码下一块到该半缓冲区
+ * @param		w		调度状态
+ * @param		half	刚播放完的半缓冲区
+ * @return	false：数据与复位间隔都已播放完，应停止 DMA
+ * @note		数据块之后是全零的复位块，超出灯珠数量的部分填 0
+ **/
+bool app_leds_wave_chunk_done(app_leds_wave_t *w, u32 *half);
+
+#endif
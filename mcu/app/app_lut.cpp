@@ -0,0 +1,120 @@
+/**
+ * @file		app_lut.cpp
+ * @brief		用于定义操作该模块的函数
+ * @note		灯光查表模块：gamma / 亮度查找表与整数混合运算
+ * @author	王广平
+ *
+ * @note
+ * 查找表全部在编译期由 constexpr 函数计算（浮点只在编译器里出现），
+ * 以 const 数组导出给 C 代码，链接后位于 flash；改 gamma 或档数只需改
+ * app_lut.h 里的宏，重新编译即可。
+ */
+
+#define __APP_LUT_C
+
+/* 头文件引用 */
+#include "app_lut.h"
+
+namespace
+{
+
+/* ln(x)，x > 0：先归一化到 [1, 2)，再用 atanh 级数 */
+constexpr double lut_ln(double x)
+{
+  constexpr double LN2 = 0.69314718055994530942;
+  int k = 0;
+  while (x >= 2.0)
+  {
+    x /= 2.0;
+    k++;
+  }
+  while (x < 1.0)
+  {
+    x *= 2.0;
+    k--;
+  }
+  double z = (x - 1.0) / (x + 1.0);
+  double z2 = z * z;
+  double term = z;
+  double sum = 0.0;
+  for (int n = 1; n < 40; n += 2)
+  {
+    sum += term / n;
+    term *= z2;
+  }
+  return 2.0 * sum + k * LN2;
+}
+
+/* exp(x)，x <= 0：先减半到 |x| < 1，用泰勒级数后再平方回去 */
+constexpr double lut_exp(double x)
+{
+  int halves = 0;
+  while (x < -1.0)
+  {
+    x /= 2.0;
+    halves++;
+  }
+  double term = 1.0;
+  double sum = 1.0;
+  for (int n = 1; n < 30; n++)
+  {
+    term *= x / n;
+    sum += term;
+  }
+  while (halves-- > 0)
+    sum *= sum;
+  return sum;
+}
+
+/* (x / 255) ^ gamma * 255，四舍五入 */
+constexpr u8 lut_gamma(double x)
+{
+  if (x <= 0.0)
+    return 0;
+  double y = lut_exp(lut_ln(x / 255.0) * (APP_LUT_GAMMA_X10 / 10.0)) * 255.0;
+  return (u8)(y + 0.5);
+}
+
+/* 第 k 行：输入先按 k / (APP_LUT_LEVELS - 1) 缩放（感知线性），再做 gamma */
+constexpr app_lut_gamma_t make_gamma()
+{
+  app_lut_gamma_t t{};
+  for (u32 k = 0; k < APP_LUT_LEVELS; k++)
+    for (u32 i = 0; i < 256; i++)
+      t.v[k][i] = lut_gamma((double)i * k / (APP_LUT_LEVELS - 1U));
+  return t;
+}
+
+/**
+ * MAX7219 亮度寄存器 n 对应占空比 (2n + 1) / 32，取与 gamma 校正后
+ * 占空比最接近的一档
+ */
+constexpr app_lut_max7219_t make_max7219()
+{
+  app_lut_max7219_t t{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    double duty32 = lut_gamma((double)i) * 32.0 / 255.0;
+    int n = (int)((duty32 - 1.0) / 2.0 + 0.5);
+    t.v[i] = (u8)((n < 0) ? 0 : (n > 15) ? 15 : n);
+  }
+  return t;
+}
+
+constexpr app_lut_gamma_t LUT_GAMMA = make_gamma();
+
+static_assert(LUT_GAMMA.v[APP_LUT_LEVELS - 1U][255] == 255, "gamma top");
+static_assert(LUT_GAMMA.v[APP_LUT_LEVELS - 1U][128] == 56, "gamma 2.2 mid");
+static_assert(LUT_GAMMA.v[0][255] == 0, "level 0 is off");
+
+} // namespace
+
+/* constinit：保证在编译期完成初始化，链接进 .rodata（flash） */
+constinit const app_lut_gamma_t app_lut_gamma = LUT_GAMMA;
+constinit const app_lut_max7219_t app_lut_max7219 = make_max7219();
+
+void app_lut_apply(u8 *buf, u32 len, const u8 *lut)
+{
+  for (u32 i = 0; i < len; i++)
+    buf[i] = lut[buf[i]];
+}
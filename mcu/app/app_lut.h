@@ -0,0 +1,111 @@
+/**
+ * @file		app_lut.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		灯光查表模块：gamma / 亮度查找表与整数混合运算
+ * @author	王广平
+ *
+ * @note
+ * 查找表由 app_lut.cpp 在编译期用 constexpr 计算，放在 flash 中，不占 RAM。
+ * 输入都是按人眼感知线性的亮度（0~255），逐像素处理只需要查表：
+ * - app_lut_gamma.v[k][v]：把 v 按亮度档 k/(APP_LUT_LEVELS-1) 缩放后做 gamma 校正，
+ *   得到 PWM 占空比或灯珠颜色分量
+ * - app_lut_max7219.v[v]：感知亮度 -> MAX7219 亮度寄存器（0x0A）的 0~15
+ * 混合与饱和运算只用整数，适合在帧合成时逐字节调用。
+ **/
+
+#ifndef __APP_LUT_H
+#define __APP_LUT_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+
+/* 宏定义 */
+// clang-format off
+
+#define APP_LUT_GAMMA_X10		22U		/* gamma 值 x10 */
+#define APP_LUT_LEVELS			16U		/* 亮度档数，第 0 档全灭，最后一档不缩放 */
+
+// clang-format on
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 查找表（flash） */
+typedef struct
+{
+  u8 v[APP_LUT_LEVELS][256]; /* [亮度档][感知亮度] -> 占空比 */
+} app_lut_gamma_t;
+
+typedef struct
+{
+  u8 v[256]; /* 感知亮度 -> MAX7219 亮度寄存器 0~15 */
+} app_lut_max7219_t;
+
+extern const app_lut_gamma_t app_lut_gamma;
+extern const app_lut_max7219_t app_lut_max7219;
+
+/* 函数声明 */
+
+/**
+ * @brief		亮度（0~255）对应的查找表行
+ * @param		level	感知亮度，255 为不缩放
+ * @return	app_lut_gamma 中最接近的一行
+ * @note		每次改亮度调用一次，逐像素只查返回的行
+ **/
+static inline const u8 *app_lut_row(u8 level)
+{
+  return app_lut_gamma.v[((u32)level * (APP_LUT_LEVELS - 1U) + 127U) / 255U];
+}
+
+/**
+ * @brief		对缓冲区逐字节查表
+ * @param		buf	缓冲区（原地改写）
+ * @param		len	字节数
+ * @param		lut	查找表，通常为 app_lut_row() 的返回值
+ **/
+void app_lut_apply(u8 *buf, u32 len, const u8 *lut);
+
+/**
+ * @brief		饱和加
+ **/
+static inline u8 app_lut_qadd8(u8 a, u8 b)
+{
+  u32 s = (u32)a + b;
+  return (s > 255U) ? 255U : (u8)s;
+}
+
+/**
+ * @brief		饱和减
+ **/
+static inline u8 app_lut_qsub8(u8 a, u8 b) { return (a > b) ? (u8)(a - b) : 0U; }
+
+/**
+ * @brief		按比例缩放
+ * @param		v	原值
+ * @param		s	比例（255 为不缩放）
+ * @return	v * (s + 1) / 256，s = 255 时等于 v，s = 0 时为 0
+ **/
+static inline u8 app_lut_scale8(u8 v, u8 s)
+{
+  return (u8)(((u32)v * ((u32)s + 1U)) >> 8);
+}
+
+/**
+ * @brief		两值线性混合
+ * @param		a	t = 0 时的值
+ * @param		b	t = 255 时的值
+ * @param		t	混合比例
+ * @return	a + (b - a) * t / 255 的整数近似，两端精确
+ **/
+static inline u8 app_lut_blend8(u8 a, u8 b, u8 t)
+{
+  u32 w = (u32)t + (t >> 7); /* 0~256 */
+  return (u8)(((u32)a * (256U - w) + (u32)b * w) >> 8);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
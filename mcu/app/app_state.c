@@ -14,6 +14,9 @@ void app_state_init(void)
   taskENTER_CRITICAL();
   APP_STATE.steer = APP_STEER_CENTER;
   APP_STATE.motion = APP_MOTION_NORMAL;
+  APP_STATE.lamp = APP_LAMP_NORMAL;
+  APP_STATE.lamp_level_left = 255;
+  APP_STATE.lamp_level_right = 255;
   APP_STATE.user_hint = false;
   taskEXIT_CRITICAL();
 }
@@ -32,6 +35,21 @@ void app_state_update_motion(app_motion_mode_t mode)
   taskEXIT_CRITICAL();
 }
 
+void app_state_update_lamp(app_lamp_mode_t mode)
+{
+  taskENTER_CRITICAL();
+  APP_STATE.lamp = mode;
+  taskEXIT_CRITICAL();
+}
+
+void app_state_update_lamp_level(uint8_t left, uint8_t right)
+{
+  taskENTER_CRITICAL();
+  APP_STATE.lamp_level_left = left;
+  APP_STATE.lamp_level_right = right;
+  taskEXIT_CRITICAL();
+}
+
 void app_state_set_user_hint(bool enabled)
 {
   taskENTER_CRITICAL();
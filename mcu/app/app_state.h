@@ -7,6 +7,7 @@
 #define __APP_STATE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef enum
 {
@@ -23,16 +24,28 @@ typedef enum
   APP_MOTION_STOP,
 } app_motion_mode_t;
 
+typedef enum
+{
+  APP_LAMP_NORMAL = 0, /* follow steer, with comfort blink on a short tap */
+  APP_LAMP_HAZARD,     /* both sides blink in phase */
+  APP_LAMP_FAULT,      /* bulb fault: the turning side blinks fast */
+} app_lamp_mode_t;
+
 typedef struct
 {
   app_steer_state_t steer;
   app_motion_mode_t motion;
+  app_lamp_mode_t lamp;
+  uint8_t lamp_level_left;  /* perceptual turn lamp level, 255 = full */
+  uint8_t lamp_level_right;
   bool user_hint;
 } app_state_snapshot_t;
 
 void app_state_init(void);
 void app_state_update_steer(app_steer_state_t state);
 void app_state_update_motion(app_motion_mode_t mode);
+void app_state_update_lamp(app_lamp_mode_t mode);
+void app_state_update_lamp_level(uint8_t left, uint8_t right);
 void app_state_set_user_hint(bool enabled);
 void app_state_get_snapshot(app_state_snapshot_t *out);
 
@@ -10,101 +10,301 @@
 /* 头文件引用 */
 #include "app_trun_lamp.h"
 #include "__port_type__.h"
+#include "app_lut.h"
 #include "app_state.h"
+#include "bsp_dma.h"
 #include "bsp_gpio.h"
+#include "bsp_timer.h"
 #include "event_bus.h"
 #include "FreeRTOS.h"
 #include "stm32f1xx_hal_gpio.h"
+#include "system_boot.h"
 #include "task.h"
+#include <stdbool.h>
+
+/* 定时器与 DMA 句柄 */
+static TIM_HandleTypeDef APP_TRUNL_TIM = {0};
+static DMA_HandleTypeDef APP_TRUNL_DMA = {0};
+
+/* 当前输出方式与亮度 */
+static app_trunL_mode_t trunL_left = APP_TRUNL_OFF;
+static app_trunL_mode_t trunL_right = APP_TRUNL_OFF;
+static u8 trunL_level_left = 255;
+static u8 trunL_level_right = 255;
+
+/* 波形步数（每个 PWM 周期一步） */
+#define TRUNL_MS_TO_STEPS(ms) ((u32)(ms) * TRUNL_PWM_HZ / 1000UL)
+#define TRUNL_WAVE_STEPS TRUNL_MS_TO_STEPS(TRUNL_BLINK_PERIOD_MS)
+#define TRUNL_ON_STEPS TRUNL_MS_TO_STEPS(TRUNL_BLINK_ON_MS)
+#define TRUNL_FADE_STEPS TRUNL_MS_TO_STEPS(TRUNL_FADE_MS)
+
+#if (TRUNL_FADE_MS * TRUNL_PWM_HZ < 1000UL) ||                                \
+    (TRUNL_BLINK_ON_MS < TRUNL_FADE_MS) ||                                     \
+    (TRUNL_BLINK_ON_MS + TRUNL_FADE_MS > TRUNL_BLINK_PERIOD_MS)
+#error "TRUNL_FADE_MS / TRUNL_BLINK_ON_MS do not fit in TRUNL_BLINK_PERIOD_MS"
+#endif
+
+/* 波形缓冲区中两列的位置，与 DMAR 突发顺序 {CCR2, CCR3} 一致 */
+#define TRUNL_COL_RIGHT 0
+#define TRUNL_COL_LEFT 1
+
+/**
+ * @brief 波形缓冲区
+ * @note 每一步按 {CCR2, CCR3} 存放，DMA 以字节读出、半字写入 DMAR，
+ * 高位补零；比较值 255 大于 ARR（254），即 100% 占空比。
+ */
+static u8 trunL_wave[TRUNL_WAVE_STEPS][2];
+
+/* 闪烁起点在波形缓冲区中的位置，以及对应的系统节拍 */
+static u32 trunL_phase = 0;
+static TickType_t trunL_phase_tick = 0;
+
+/* 第 N 次闪烁熄灭（渐灭结束）时距闪烁起点的时间 */
+#define TRUNL_FLASHES_MS(n)                                                    \
+  (((n) - 1U) * TRUNL_BLINK_PERIOD_MS + TRUNL_BLINK_ON_MS + TRUNL_FADE_MS)
+
+/**
+ * @brief 闪烁波形在第 k 步的感知亮度（0~255）
+ * @note 渐亮 TRUNL_FADE_STEPS 步 -> 保持到 TRUNL_ON_STEPS -> 渐灭 -> 熄灭
+ */
+static u32 app_trunL_blink_shape(u32 k)
+{
+  if (k < TRUNL_FADE_STEPS)
+    return (k + 1U) * 255U / TRUNL_FADE_STEPS;
+  if (k < TRUNL_ON_STEPS)
+    return 255U;
+  if (k < TRUNL_ON_STEPS + TRUNL_FADE_STEPS)
+    return 255U - (k - TRUNL_ON_STEPS + 1U) * 255U / TRUNL_FADE_STEPS;
+  return 0;
+}
+
+/**
+ * @brief 按输出方式与亮度改写波形缓冲区中的一列
+ * @note DMA 正在循环读取该缓冲区，逐字节改写，最多有一步混用新旧值
+ */
+static void app_trunL_fill(u32 col, app_trunL_mode_t mode, u8 level)
+{
+  const u8 *lut = app_lut_row(level);
+
+  for (u32 i = 0; i < TRUNL_WAVE_STEPS; i++)
+  {
+    u32 p;
+    switch (mode)
+    {
+    case APP_TRUNL_ON:
+      p = 255U;
+      break;
+    case APP_TRUNL_BLINK:
+      p = app_trunL_blink_shape((i + TRUNL_WAVE_STEPS - trunL_phase) %
+                                TRUNL_WAVE_STEPS);
+      break;
+    case APP_TRUNL_FAST:
+      p = app_trunL_blink_shape(((i + TRUNL_WAVE_STEPS - trunL_phase) * 2U) %
+                                TRUNL_WAVE_STEPS);
+      break;
+    case APP_TRUNL_OFF:
+    default:
+      p = 0;
+      break;
+    }
+    trunL_wave[i][col] = lut[p];
+  }
+}
+
+/**
+ * @brief DMA 下一次要读取的步
+ */
+static inline u32 app_trunL_next_step()
+{
+  u32 remain = __HAL_DMA_GET_COUNTER(&APP_TRUNL_DMA);
+  return ((TRUNL_WAVE_STEPS * 2UL - remain) / 2UL) % TRUNL_WAVE_STEPS;
+}
 
 RESULT_Init app_trunL_init()
 {
   RESULT_Init ret = ERR_Init_Start;
-  /* 初始化左转灯 */
-  bsp_gpio_Init(LEFT_GPIOx, LEFT_PIN, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL,
-                GPIO_SPEED_FREQ_LOW);
-  /* 初始化右转灯 */
-  bsp_gpio_Init(RIGHT_GPIOx, RIGHT_PIN, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL,
-                GPIO_SPEED_FREQ_LOW);
-  /* 初始化关闭所有灯 */
-  HAL_GPIO_WritePin(LEFT_GPIOx, LEFT_PIN, GPIO_PIN_RESET);
-  HAL_GPIO_WritePin(RIGHT_GPIOx, RIGHT_PIN, GPIO_PIN_RESET);
+
+  /* 初始化左右转灯引脚（TIM2_CH3/PA2、TIM2_CH2/PA1） */
+  bsp_gpio_AFPP_Init(LEFT_GPIOx, LEFT_PIN);
+  bsp_gpio_AFPP_Init(RIGHT_GPIOx, RIGHT_PIN);
+
+  /* TIM2：计数到 TRUNL_PWM_FULL 为一个 PWM 周期，频率为 TRUNL_PWM_HZ */
+  bsp_timer_SetStruct(
+      &APP_TRUNL_TIM, TRUNL_TIMx,
+      (SYSTEM_BOOT_APB1_TIMER_HZ / (TRUNL_PWM_HZ * TRUNL_PWM_FULL)) - 1UL,
+      TIM_COUNTERMODE_UP, TRUNL_PWM_FULL - 1UL, TIM_CLOCKDIVISION_DIV1,
+      TIM_AUTORELOAD_PRELOAD_DISABLE, 0);
+
+  /* 初始化关闭所有灯（CCR = 0） */
+  ret = bsp_timer_PWM_init(&APP_TRUNL_TIM, TIM_OCMODE_PWM1, 0,
+                           TIM_OCPOLARITY_HIGH, TIM_OCFAST_DISABLE,
+                           TIM_OCIDLESTATE_RESET, TIM_OCNIDLESTATE_RESET,
+                           TIM_OCNPOLARITY_HIGH, LEFT_CHANNEL);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  ret = bsp_timer_PWM_init(&APP_TRUNL_TIM, TIM_OCMODE_PWM1, 0,
+                           TIM_OCPOLARITY_HIGH, TIM_OCFAST_DISABLE,
+                           TIM_OCIDLESTATE_RESET, TIM_OCNIDLESTATE_RESET,
+                           TIM_OCNPOLARITY_HIGH, RIGHT_CHANNEL);
+  if (ret != ERR_Init_Finished)
+    return ret;
+
+  /**
+   * @brief DMA 突发写入
+   * @note 每个更新事件通过 DMAR 写入下一步的 CCR2、CCR3，CCR 预装载保持
+   * 开启，新值在下一个周期开始时生效，不会出现半个周期的毛刺。
+   * 不使能 DMA 中断：循环播放不需要 CPU 参与。
+   */
+  DMA_Init_Config dma_cfg = bsp_dma_conf_PWMwave(TRUNL_DMA_CHANNEL);
+  ret = bsp_dma_init(&APP_TRUNL_DMA, &dma_cfg);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  __HAL_LINKDMA(&APP_TRUNL_TIM, hdma[TIM_DMA_ID_UPDATE], APP_TRUNL_DMA);
+
+  if (HAL_TIM_DMABurst_MultiWriteStart(
+          &APP_TRUNL_TIM, TIM_DMABASE_CCR2, TIM_DMA_UPDATE,
+          (uint32_t *)trunL_wave, TIM_DMABURSTLENGTH_2TRANSFERS,
+          TRUNL_WAVE_STEPS * 2UL) != HAL_OK)
+    return ERR_Init_ERROR_DMA;
+
   ret = ERR_Init_Finished;
   return ret;
 }
 
-RESULT_RUN app_trunL_open_left()
+/**
+ * @brief 输出方式是否为闪烁（含快闪）
+ */
+static inline bool app_trunL_is_blink(app_trunL_mode_t mode)
 {
-  HAL_GPIO_WritePin(LEFT_GPIOx, LEFT_PIN, GPIO_PIN_SET);
+  return (mode == APP_TRUNL_BLINK) || (mode == APP_TRUNL_FAST);
+}
+
+RESULT_RUN app_trunL_set(app_trunL_mode_t left, app_trunL_mode_t right)
+{
+  bool was_blinking =
+      app_trunL_is_blink(trunL_left) || app_trunL_is_blink(trunL_right);
+
+  trunL_left = left;
+  trunL_right = right;
+
+  /* 新开始闪烁：波形起点移到 DMA 下一步，从下一个 PWM 周期起渐亮 */
+  if (!was_blinking && (app_trunL_is_blink(left) || app_trunL_is_blink(right)))
+  {
+    trunL_phase = app_trunL_next_step();
+    trunL_phase_tick = xTaskGetTickCount();
+  }
+
+  app_trunL_fill(TRUNL_COL_LEFT, left, trunL_level_left);
+  app_trunL_fill(TRUNL_COL_RIGHT, right, trunL_level_right);
   return ERR_RUN_Finished;
 }
 
+RESULT_RUN app_trunL_set_level(u8 left, u8 right)
+{
+  trunL_level_left = left;
+  trunL_level_right = right;
+  return app_trunL_set(trunL_left, trunL_right);
+}
+
+RESULT_RUN app_trunL_open_left()
+{
+  return app_trunL_set(APP_TRUNL_ON, trunL_right);
+}
+
 RESULT_RUN app_trunL_open_right()
 {
-  HAL_GPIO_WritePin(RIGHT_GPIOx, RIGHT_PIN, GPIO_PIN_SET);
-  return ERR_RUN_Finished;
+  return app_trunL_set(trunL_left, APP_TRUNL_ON);
 }
 
 RESULT_RUN app_trunL_close_left()
 {
-  HAL_GPIO_WritePin(LEFT_GPIOx, LEFT_PIN, GPIO_PIN_RESET);
-  return ERR_RUN_Finished;
+  return app_trunL_set(APP_TRUNL_OFF, trunL_right);
 }
 
 RESULT_RUN app_trunL_close_right()
 {
-  HAL_GPIO_WritePin(RIGHT_GPIOx, RIGHT_PIN, GPIO_PIN_RESET);
-  return ERR_RUN_Finished;
+  return app_trunL_set(trunL_left, APP_TRUNL_OFF);
 }
 
+/**
+ * @brief 由转向状态、转向灯模式和舒适闪烁计算左右输出
+ * @param steer   当前转向状态
+ * @param lamp    当前转向灯模式
+ * @param comfort 正在补足舒适闪烁的一侧，CENTER 表示没有
+ */
+static void app_trunL_schedule(app_steer_state_t steer, app_lamp_mode_t lamp,
+                               app_steer_state_t comfort,
+                               app_trunL_mode_t *left, app_trunL_mode_t *right)
+{
+  app_steer_state_t side = (steer != APP_STEER_CENTER) ? steer : comfort;
+  app_trunL_mode_t blink =
+      (lamp == APP_LAMP_FAULT) ? APP_TRUNL_FAST : APP_TRUNL_BLINK;
+
+  if (lamp == APP_LAMP_HAZARD)
+  {
+    *left = APP_TRUNL_BLINK;
+    *right = APP_TRUNL_BLINK;
+    return;
+  }
+
+  *left = (side == APP_STEER_LEFT) ? blink : APP_TRUNL_OFF;
+  *right = (side == APP_STEER_RIGHT) ? blink : APP_TRUNL_OFF;
+}
+
+/**
+ * @note 闪烁由 TIM2 + DMA 输出，线程只在收到 SIG_LAMP_UPDATE 时重新调度，
+ * 舒适闪烁另外在补足时唤醒一次；输出不变时不改写波形，重复事件不会打断
+ * 闪烁相位。
+ */
 void app_trunL_dispose_Task()
 {
   EventGroupHandle_t evt = event_bus_getHandle();
-  app_steer_state_t state = APP_STEER_CENTER;
-  u8 blink_on = 0; /* 0=灭,1=亮 */
-  const TickType_t blink_period = pdMS_TO_TICKS(500);
+  app_steer_state_t steer = APP_STEER_CENTER;
+  app_steer_state_t comfort = APP_STEER_CENTER;
+  const TickType_t comfort_ticks =
+      pdMS_TO_TICKS(TRUNL_FLASHES_MS(TRUNL_COMFORT_FLASHES));
 
-  app_trunL_close_left();
-  app_trunL_close_right();
+  app_trunL_set(APP_TRUNL_OFF, APP_TRUNL_OFF);
 
   while (1)
   {
-    TickType_t wait_ticks =
-        (state == APP_STEER_CENTER) ? portMAX_DELAY : blink_period;
-    EventBits_t bits = xEventGroupWaitBits(evt, SIG_LAMP_UPDATE, pdTRUE,
-                                           pdFALSE, wait_ticks);
-
-    if (bits & SIG_LAMP_UPDATE)
+    TickType_t wait = portMAX_DELAY;
+    if (comfort != APP_STEER_CENTER)
     {
-      app_state_snapshot_t snapshot;
-      app_state_get_snapshot(&snapshot);
-      state = snapshot.steer;
-      blink_on = (state == APP_STEER_CENTER) ? 0 : 1;
+      TickType_t elapsed = xTaskGetTickCount() - trunL_phase_tick;
+      wait = (elapsed < comfort_ticks) ? (comfort_ticks - elapsed) : 0;
     }
+    (void)xEventGroupWaitBits(evt, SIG_LAMP_UPDATE, pdTRUE, pdFALSE, wait);
 
-    switch (state)
-    {
-    case APP_STEER_LEFT:
-      if (bits == 0) /* 超时：到达闪烁周期，翻转一次 */
-        blink_on = (u8)!blink_on;
-      HAL_GPIO_WritePin(LEFT_GPIOx, LEFT_PIN,
-                        blink_on ? GPIO_PIN_SET : GPIO_PIN_RESET);
-      HAL_GPIO_WritePin(RIGHT_GPIOx, RIGHT_PIN, GPIO_PIN_RESET);
-      break;
+    app_state_snapshot_t snapshot;
+    app_state_get_snapshot(&snapshot);
+    /* 从本次闪烁起点算起，是否已满 TRUNL_COMFORT_FLASHES 次 */
+    bool flashes_done =
+        (xTaskGetTickCount() - trunL_phase_tick) >= comfort_ticks;
 
-    case APP_STEER_RIGHT:
-      if (bits == 0)
-        blink_on = (u8)!blink_on;
-      HAL_GPIO_WritePin(RIGHT_GPIOx, RIGHT_PIN,
-                        blink_on ? GPIO_PIN_SET : GPIO_PIN_RESET);
-      HAL_GPIO_WritePin(LEFT_GPIOx, LEFT_PIN, GPIO_PIN_RESET);
-      break;
+    /* 舒适闪烁已补足 */
+    if (comfort != APP_STEER_CENTER && flashes_done)
+      comfort = APP_STEER_CENTER;
 
-    case APP_STEER_CENTER:
-    default:
-      app_trunL_close_left();
-      app_trunL_close_right();
-      break;
+    if (snapshot.steer != steer)
+    {
+      /* 回正：本次闪烁未满则补足；其余转向变化都取消舒适闪烁 */
+      if (snapshot.steer == APP_STEER_CENTER && TRUNL_COMFORT_FLASHES != 0U &&
+          snapshot.lamp != APP_LAMP_HAZARD && !flashes_done)
+        comfort = steer;
+      else
+        comfort = APP_STEER_CENTER;
+      steer = snapshot.steer;
     }
+
+    /* 亮度由动画等其他线程经 app_state 下发，在本线程内生效 */
+    if (snapshot.lamp_level_left != trunL_level_left ||
+        snapshot.lamp_level_right != trunL_level_right)
+      app_trunL_set_level(snapshot.lamp_level_left, snapshot.lamp_level_right);
+
+    app_trunL_mode_t left, right;
+    app_trunL_schedule(steer, snapshot.lamp, comfort, &left, &right);
+    if (left != trunL_left || right != trunL_right)
+      app_trunL_set(left, right);
   }
 }
@@ -10,6 +10,8 @@
 
 /* 头文件引用 */
 #include "ERR.h"
+#include "__port_type__.h"
+#include "stm32f1xx_hal_tim.h"
 
 /* 宏定义 */
 
@@ -21,9 +23,49 @@
 #define LEFT_GPIOx		GPIOA				/* 左转灯GPIO分组 */
 #define RIGHT_GPIOx		GPIOA				/* 右转灯GPIO分组 */
 
+/**
+ * @brief 亮度由定时器 PWM 输出，亮度波形由 DMA 逐周期写入
+ * @note
+ * PA2/PA1 分别是 TIM2_CH3/TIM2_CH2。TIM2 以 TRUNL_PWM_HZ 输出 8 位 PWM，
+ * 每个 PWM 周期的更新事件触发一次 DMA 突发，从波形缓冲区取下一步的
+ * {CCR2, CCR3} 写入，缓冲区正好是一个闪烁周期，循环播放：
+ * - 渐亮/渐灭按 gamma 表换算成占空比，每步 1/TRUNL_PWM_HZ 秒
+ * - 两路共用一个缓冲区和周期，闪烁相位一致
+ * 线程只在输出方式或亮度变化时改写缓冲区中对应的一列，每一步都不占用 CPU。
+ */
+#define TRUNL_TIMx							TIM2
+#define LEFT_CHANNEL						TIM_CHANNEL_3
+#define RIGHT_CHANNEL						TIM_CHANNEL_2
+#define TRUNL_DMA_CHANNEL				DMA1_Channel2	/* TIM2_UP */
+#define TRUNL_PWM_HZ						200UL		/* PWM 频率，也是波形步进频率 */
+#define TRUNL_PWM_FULL					255U		/* 比较值满量程，ARR = FULL - 1 */
+#define TRUNL_BLINK_PERIOD_MS		1000U		/* 闪烁周期 */
+#define TRUNL_BLINK_ON_MS				500U		/* 每个周期点亮的时间（含渐亮） */
+#define TRUNL_FADE_MS						100U		/* 渐亮/渐灭时间 */
+
+/**
+ * @brief 模式调度
+ * @note
+ * 所有闪烁都取自同一个波形缓冲区和同一个相位，左右两路始终同相：
+ * - 舒适闪烁：转向回正时若闪烁未满 TRUNL_COMFORT_FLASHES 次，补足后熄灭
+ * - 双闪：两路按 TRUNL_BLINK_PERIOD_MS 闪烁
+ * - 灯泡故障：转向一侧按半个周期快闪
+ * 线程只在状态变化和舒适闪烁结束时各唤醒一次，不为每次闪烁唤醒。
+ */
+#define TRUNL_COMFORT_FLASHES		3U			/* 舒适闪烁次数，0 关闭 */
+
 // clang-format on
 #endif
 
+/* 单个灯的输出方式 */
+typedef enum
+{
+  APP_TRUNL_OFF = 0, /* 熄灭 */
+  APP_TRUNL_ON,      /* 常亮 */
+  APP_TRUNL_BLINK,   /* 按 TRUNL_BLINK_PERIOD_MS 闪烁 */
+  APP_TRUNL_FAST,    /* 按 TRUNL_BLINK_PERIOD_MS / 2 快闪，与 BLINK 同相 */
+} app_trunL_mode_t;
+
 /* 函数声明 */
 
 /**
@@ -61,6 +103,28 @@ RESULT_RUN app_trunL_close_left();
  **/
 RESULT_RUN app_trunL_close_right();
 
+/**
+ * @brief		左右灯同时切换输出方式
+ * @param		left	左灯输出方式
+ * @param		right	右灯输出方式
+ * @return	运行结果
+ * @note
+ * 原来没有灯在闪烁、这次开始闪烁时从下一个 PWM 周期起渐亮；
+ * 已经在闪烁时不打断当前相位。之后的每一步都由 DMA 完成，不占用 CPU。
+ **/
+RESULT_RUN app_trunL_set(app_trunL_mode_t left, app_trunL_mode_t right);
+
+/**
+ * @brief		设置左右灯亮度
+ * @param		left	左灯亮度（按人眼感知线性，0~255）
+ * @param		right	右灯亮度
+ * @return	运行结果
+ * @note
+ * 常亮与闪烁的峰值都按该亮度缩放（按 APP_LUT_LEVELS 档查表），默认 255。
+ * 只在转向灯线程内调用；其他线程经 app_state_update_lamp_level() 下发
+ **/
+RESULT_RUN app_trunL_set_level(u8 left, u8 right);
+
 /**
  * @brief 处理线程函数
  * @date  2025/12/9
@@ -87,9 +87,11 @@
 /* ============================== 协议字段定义 ============================== */
 /**
  * @brief “can总线通信帧格式.png”中定义的协议字段位置
- * @note 本项目目前只关心 Byte2（点阵灯模式：加速/减速/停车/正常）
+ * @note 本项目目前只关心 Byte2（点阵灯模式：加速/减速/停车/正常），
+ * 以及协议中预留扩展用的 Byte3（转向灯模式：跟随转向/双闪/灯泡故障）
  */
 #define BSP_CAN_CMD_BYTE_DOT_MODE 2
+#define BSP_CAN_CMD_BYTE_LAMP_MODE 3
 
 typedef enum
 {
@@ -99,6 +101,13 @@ typedef enum
   BSP_CAN_DOT_MODE_NORMAL = 0x03, /* 正常/无动作 */
 } BSP_CAN_DOT_MODE_T;
 
+typedef enum
+{
+  BSP_CAN_LAMP_MODE_NORMAL = 0x00, /* 跟随转向 */
+  BSP_CAN_LAMP_MODE_HAZARD = 0x01, /* 双闪 */
+  BSP_CAN_LAMP_MODE_FAULT = 0x02,  /* 灯泡故障，快闪 */
+} BSP_CAN_LAMP_MODE_T;
+
 /* ============================== 数据结构定义 ============================== */
 /**
  * @brief CAN 消息结构体（用于应用层读取）
@@ -20,6 +20,7 @@
 RESULT_Init bsp_dma_init(DMA_HandleTypeDef *hdma, DMA_Init_Config *cfg)
 {
   __HAL_RCC_DMA1_CLK_ENABLE();
+  hdma->Instance = cfg->Channel;
   hdma->Init.Direction = cfg->Direction;
   hdma->Init.PeriphInc = cfg->PeriphInc;
   hdma->Init.MemInc = cfg->MemInc;
@@ -56,16 +57,108 @@ DMA_Init_Config bsp_dma_conf_usartRX(DMA_Channel_TypeDef *channel)
   return cfg;
 }
 
+/**
+ * @brief   dma在定时器输入捕获（PWM 测量）模式下的配置函数
+ * @param   channel 指定需用使用的通道
+ * @note
+ * 外设端固定为 TIMx->DMAR（突发访问 CCRx），内存端递增写入环形缓冲区，
+ * 循环模式下由调用者根据 CNDTR 计算写指针。
+ *
+ * @date    2025/12/2
+ */
 DMA_Init_Config bsp_dma_conf_PWM(DMA_Channel_TypeDef *channel)
 {
   DMA_Init_Config cfg;
   cfg.Channel = channel;
   cfg.Direction = DMA_PERIPH_TO_MEMORY;
   cfg.PeriphInc = DMA_PINC_DISABLE;
-  cfg.MemInc = DMA_MINC_DISABLE;
+  cfg.MemInc = DMA_MINC_ENABLE;
+  cfg.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  cfg.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+  cfg.Mode = DMA_CIRCULAR;
+  cfg.Priority = DMA_PRIORITY_HIGH;
+  return cfg;
+}
+
+/**
+ * @brief   dma在SPI接收（16 位帧）模式下的配置函数
+ * @param   channel 指定需用使用的通道
+ * @note
+ * 外设端固定为 SPIx->DR，内存端递增写入环形缓冲区，循环模式。
+ */
+DMA_Init_Config bsp_dma_conf_spiRX(DMA_Channel_TypeDef *channel)
+{
+  DMA_Init_Config cfg;
+  cfg.Channel = channel;
+  cfg.Direction = DMA_PERIPH_TO_MEMORY;
+  cfg.PeriphInc = DMA_PINC_DISABLE;
+  cfg.MemInc = DMA_MINC_ENABLE;
   cfg.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
   cfg.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
   cfg.Mode = DMA_CIRCULAR;
   cfg.Priority = DMA_PRIORITY_HIGH;
   return cfg;
+}
+
+/**
+ * @brief   dma在SPI发送（8 位帧）模式下的配置函数
+ * @param   channel 指定需用使用的通道
+ * @note
+ * 外设端固定为 SPIx->DR，内存端按字节递增读取发送缓冲区，单次模式，
+ * 每次启动发送一段，由传输完成中断接续下一段。
+ */
+DMA_Init_Config bsp_dma_conf_spiTX(DMA_Channel_TypeDef *channel)
+{
+  DMA_Init_Config cfg;
+  cfg.Channel = channel;
+  cfg.Direction = DMA_MEMORY_TO_PERIPH;
+  cfg.PeriphInc = DMA_PINC_DISABLE;
+  cfg.MemInc = DMA_MINC_ENABLE;
+  cfg.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  cfg.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  cfg.Mode = DMA_NORMAL;
+  cfg.Priority = DMA_PRIORITY_MEDIUM;
+  return cfg;
+}
+
+/**
+ * @brief   dma由定时器请求触发、重复写同一个外设寄存器的配置函数
+ * @param   channel 指定需用使用的通道
+ * @note
+ * 内存端与外设端都不递增，按字传输，循环模式：每个请求把同一个值写入
+ * 外设寄存器（如 GPIOx->BSRR 翻转片选、SPIx->DR 发起一帧），不占用 CPU。
+ */
+DMA_Init_Config bsp_dma_conf_regWrite(DMA_Channel_TypeDef *channel)
+{
+  DMA_Init_Config cfg;
+  cfg.Channel = channel;
+  cfg.Direction = DMA_MEMORY_TO_PERIPH;
+  cfg.PeriphInc = DMA_PINC_DISABLE;
+  cfg.MemInc = DMA_MINC_DISABLE;
+  cfg.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  cfg.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  cfg.Mode = DMA_CIRCULAR;
+  cfg.Priority = DMA_PRIORITY_VERY_HIGH;
+  return cfg;
+}
+
+/**
+ * @brief   dma在定时器 PWM 输出（比较值波形）模式下的配置函数
+ * @param   channel 指定需用使用的通道
+ * @note
+ * 外设端固定为 TIMx->DMAR（突发写入 CCRx），内存端按字节递增读取波形
+ * 缓冲区，写入外设时高位补零，循环模式下波形反复播放。
+ */
+DMA_Init_Config bsp_dma_conf_PWMwave(DMA_Channel_TypeDef *channel)
+{
+  DMA_Init_Config cfg;
+  cfg.Channel = channel;
+  cfg.Direction = DMA_MEMORY_TO_PERIPH;
+  cfg.PeriphInc = DMA_PINC_DISABLE;
+  cfg.MemInc = DMA_MINC_ENABLE;
+  cfg.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  cfg.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  cfg.Mode = DMA_CIRCULAR;
+  cfg.Priority = DMA_PRIORITY_MEDIUM;
+  return cfg;
 }
\ No newline at end of file
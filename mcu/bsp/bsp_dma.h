@@ -26,4 +26,8 @@ typedef struct
 RESULT_Init bsp_dma_init(DMA_HandleTypeDef *hdma, DMA_Init_Config *cfg);
 DMA_Init_Config bsp_dma_conf_usartRX(DMA_Channel_TypeDef *channel);
 DMA_Init_Config bsp_dma_conf_PWM(DMA_Channel_TypeDef *channel);
+DMA_Init_Config bsp_dma_conf_spiRX(DMA_Channel_TypeDef *channel);
+DMA_Init_Config bsp_dma_conf_spiTX(DMA_Channel_TypeDef *channel);
+DMA_Init_Config bsp_dma_conf_regWrite(DMA_Channel_TypeDef *channel);
+DMA_Init_Config bsp_dma_conf_PWMwave(DMA_Channel_TypeDef *channel);
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file		bsp_flash.c
+ * @brief		用于定义该模块的函数
+ * @note		片内 Flash 页擦除与编程
+ * @author	王广平
+ */
+
+/* 头文件引用 */
+#include "bsp_flash.h"
+#include "stm32f1xx_hal.h"
+#include "stm32f1xx_hal_flash.h"
+#include "stm32f1xx_hal_flash_ex.h"
+
+RESULT_RUN bsp_flash_erase_page(u32 page_addr)
+{
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t page_err = 0;
+  HAL_StatusTypeDef st;
+
+  if ((page_addr % BSP_FLASH_PAGE_SIZE) != 0U)
+    return ERR_RUN_ERROR_ERIP;
+
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.PageAddress = page_addr;
+  erase.NbPages = 1;
+
+  HAL_FLASH_Unlock();
+  st = HAL_FLASHEx_Erase(&erase, &page_err);
+  HAL_FLASH_Lock();
+
+  return (st == HAL_OK) ? ERR_RUN_Finished : ERR_RUN_ERROR_CALL;
+}
+
+RESULT_RUN bsp_flash_write(u32 addr, const void *data, u32 len)
+{
+  const u16 *src = (const u16 *)data;
+  RESULT_RUN ret = ERR_RUN_Finished;
+  u32 i = 0;
+
+  if (data == NULL || (addr & 1U) != 0U || (len & 1U) != 0U)
+    return ERR_RUN_ERROR_ERIP;
+
+  HAL_FLASH_Unlock();
+  for (i = 0; i < len / 2U; i++)
+  {
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, addr + i * 2U,
+                          src[i]) != HAL_OK)
+    {
+      ret = ERR_RUN_ERROR_CALL;
+      break;
+    }
+  }
+  HAL_FLASH_Lock();
+
+  return ret;
+}
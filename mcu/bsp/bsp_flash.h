@@ -0,0 +1,39 @@
+/**
+ * @file		bsp_flash.h
+ * @brief		定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		片内 Flash 页擦除与编程
+ * @author	王广平
+ **/
+
+#ifndef __BSP_FLASH_H
+#define __BSP_FLASH_H
+
+/* 头文件引用 */
+#include "ERR.h"
+#include "__port_type__.h"
+
+/* 宏定义 */
+#define BSP_FLASH_PAGE_SIZE 1024U /* STM32F103C8 页大小 */
+
+/* 函数声明 */
+
+/**
+ * @brief 擦除一页 Flash
+ *
+ * @param page_addr 页起始地址（需按 BSP_FLASH_PAGE_SIZE 对齐）
+ * @return RESULT_RUN 运行结果
+ * @note 擦除期间 CPU 取指会被挂起（约 20ms），只应在非实时路径调用
+ */
+RESULT_RUN bsp_flash_erase_page(u32 page_addr);
+
+/**
+ * @brief 按半字编程一段 Flash
+ *
+ * @param addr	目标地址（需半字对齐，且对应区域已擦除）
+ * @param data	数据源
+ * @param len		数据长度（字节，需为 2 的整数倍）
+ * @return RESULT_RUN 运行结果
+ */
+RESULT_RUN bsp_flash_write(u32 addr, const void *data, u32 len);
+
+#endif
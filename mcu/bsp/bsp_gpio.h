@@ -12,6 +12,64 @@
 #include "__port_type__.h"
 #include "stm32f103xb.h"
 
+/**
+ * @brief 引脚描述：同一分组内的一个或多个引脚
+ * @note
+ * 用 BSP_GPIO_PIN() 定义为 static const，分组与掩码都是编译期常量，
+ * 配合下面的内联函数，每次输出只编译为一次 BSRR 写入：
+ * - 同一次写入中置位与复位同时生效，多个引脚不会出现中间状态
+ * - 不经过 HAL 的参数检查与分支
+ */
+typedef struct
+{
+  GPIO_TypeDef *port; /* GPIO 分组 */
+  u16 mask;           /* 引脚掩码（GPIO_PIN_x 按位或） */
+} bsp_gpio_pin_t;
+
+/* 定义引脚描述 */
+#define BSP_GPIO_PIN(GPIOx, pins) {(GPIOx), (u16)(pins)}
+
+/* 计算 BSRR 写入值：低 16 位置位，高 16 位复位 */
+#define BSP_GPIO_BSRR(set, reset)                                              \
+  ((((u32)(reset) & 0xFFFFU) << 16) | ((u32)(set) & 0xFFFFU))
+
+/**
+ * @brief 在一次 BSRR 写入中置位、复位同一分组的任意引脚
+ * @param GPIOx 指定GPIO分组
+ * @param set   需置位的引脚掩码
+ * @param reset 需复位的引脚掩码（与 set 重叠的引脚以置位为准）
+ */
+static inline void bsp_gpio_WriteMask(GPIO_TypeDef *GPIOx, u16 set, u16 reset)
+{
+  GPIOx->BSRR = BSP_GPIO_BSRR(set, reset);
+}
+
+/**
+ * @brief 置位引脚描述中的全部引脚
+ */
+static inline void bsp_gpio_Set(bsp_gpio_pin_t pin)
+{
+  pin.port->BSRR = BSP_GPIO_BSRR(pin.mask, 0);
+}
+
+/**
+ * @brief 复位引脚描述中的全部引脚
+ */
+static inline void bsp_gpio_Reset(bsp_gpio_pin_t pin)
+{
+  pin.port->BSRR = BSP_GPIO_BSRR(0, pin.mask);
+}
+
+/**
+ * @brief 按 value 输出引脚描述中的全部引脚
+ * @param pin   引脚描述
+ * @param value 各引脚电平（按位对应，只有 pin.mask 内的位有效）
+ */
+static inline void bsp_gpio_Write(bsp_gpio_pin_t pin, u16 value)
+{
+  pin.port->BSRR = BSP_GPIO_BSRR(pin.mask & value, pin.mask & (u16)~value);
+}
+
 /* 函数声明 */
 RESULT_Init bsp_gpio_Init(GPIO_TypeDef *GPIOx, u32 GPIOpin, u32 GPIOMode,
                           u32 GPIOPull, u32 GPIOSpeed);
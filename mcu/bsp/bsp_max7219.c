@@ -1,16 +1,225 @@
 /**
  * @file bsp_max7219.c
  * @brief MAX7219 board support driver implementation.
+ *
+ * @note
+ * 支持 BSP_MAX7219_CHAIN 片级联。级联时数据从第 0 片的 DIN 移入、从最后
+ * 一片移出，一次片选内先发出的 16 位落在最远的一片；CS 上升沿时各片同时
+ * 锁存自己移位寄存器中的一个寄存器。因此同一行在所有片上的寄存器放在
+ * 一次片选内发出，整链刷新为 8 次突发；控制寄存器同样一次片选写入所有
+ * 片，各片的值可以不同（如亮度）。
+ *
+ * 帧缓冲区按逻辑方向保存，发送时按每片的旋转设置换算成实际行数据，
+ * 再与行寄存器影子比较，只发送有变化的行；发送失败的行记为待重发。
+ * 干扰可能改写芯片内的寄存器而影子察觉不到，bsp_max7219_refresh()
+ * 按影子重写全部配置与行寄存器。
+ *
+ * STM32F1 的 SPI 没有 NSS 脉冲模式，也没有空闲定时器可以由 DMA 翻转
+ * 片选，所以异步发送以行为单位：DMA 发出一行（2 * 片数字节），传输完成
+ * 中断里等总线空闲、拉高片选，再启动下一行。
  */
 
 #include "bsp_max7219.h"
+#include "bsp_dma.h"
 #include "bsp_gpio.h"
 #include "bsp_spi.h"
+#include "stm32f1xx_hal_cortex.h"
 #include "stm32f1xx_hal_gpio.h"
 #include "stm32f1xx_hal_spi.h"
+#include <string.h>
+
+/* 一次片选发出的字节数 */
+#define BSP_MAX7219_BURST (2U * BSP_MAX7219_CHAIN)
 
 static SPI_HandleTypeDef BSP_MAX7219_HANDLE = {0};
 static bool BSP_MAX7219_READY = false;
+static const bsp_gpio_pin_t BSP_MAX7219_CS =
+    BSP_GPIO_PIN(BSP_MAX7219_GPIOx, BSP_MAX7219_CS_PIN);
+
+/* 帧缓冲区（逻辑方向）与每片的旋转、亮度 */
+static u8 BSP_MAX7219_FRAME[BSP_MAX7219_CHAIN][8] = {0};
+static u8 BSP_MAX7219_ROTATION[BSP_MAX7219_CHAIN] = {0};
+static u8 BSP_MAX7219_INTENSITY[BSP_MAX7219_CHAIN];
+
+/* 行寄存器影子（旋转后的实际数据）、待重发的行（bit0 对应第 1 行） */
+static u8 BSP_MAX7219_SHADOW[BSP_MAX7219_CHAIN][8] = {0};
+static u8 BSP_MAX7219_STALE = 0xFF;
+
+/* 异步发送：待发的行（每行一次突发）与进度 */
+static DMA_HandleTypeDef BSP_MAX7219_DMA = {0};
+static u8 BSP_MAX7219_TX[8][BSP_MAX7219_BURST];
+static u8 BSP_MAX7219_TX_ROW[8];
+static u8 BSP_MAX7219_TX_COUNT = 0;
+static u8 BSP_MAX7219_TX_NEXT = 0;
+static volatile bool BSP_MAX7219_BUSY = false;
+static bsp_max7219_done_fn BSP_MAX7219_DONE = NULL;
+
+/**
+ * @brief 顺时针旋转 90°
+ */
+static void bsp_max7219_turn_once(const u8 in[8], u8 out[8])
+{
+  for (u8 r = 0; r < 8; r++)
+  {
+    u8 new_row = 0;
+    for (u8 c = 0; c < 8; c++)
+      new_row |= (u8)(((in[7 - c] >> r) & 1U) << (7 - c));
+    out[r] = new_row;
+  }
+}
+
+/**
+ * @brief 把帧缓冲区换算成各片实际行数据，与影子比较
+ * @param phys 输出各片实际行数据
+ * @return 需要发送的行（bit0 对应第 1 行），这些行已写入影子并记为待重发
+ */
+static u8 bsp_max7219_diff(u8 phys[BSP_MAX7219_CHAIN][8])
+{
+  u8 mask = BSP_MAX7219_STALE;
+
+  for (u8 dev = 0; dev < BSP_MAX7219_CHAIN; dev++)
+  {
+    memcpy(phys[dev], BSP_MAX7219_FRAME[dev], 8);
+    for (u8 i = 0; i < BSP_MAX7219_ROTATION[dev]; i++)
+    {
+      u8 tmp[8];
+      bsp_max7219_turn_once(phys[dev], tmp);
+      memcpy(phys[dev], tmp, 8);
+    }
+    for (u8 row = 0; row < 8; row++)
+      if (phys[dev][row] != BSP_MAX7219_SHADOW[dev][row])
+        mask |= (u8)(1U << row);
+  }
+
+  memcpy(BSP_MAX7219_SHADOW, phys, sizeof(BSP_MAX7219_SHADOW));
+  BSP_MAX7219_STALE = mask;
+  return mask;
+}
+
+/**
+ * @brief 打包一行：最远的一片先发
+ */
+static void bsp_max7219_pack_row(u8 row, u8 phys[BSP_MAX7219_CHAIN][8],
+                                 u8 buf[BSP_MAX7219_BURST])
+{
+  for (u8 i = 0; i < BSP_MAX7219_CHAIN; i++)
+  {
+    buf[2 * i] = row + 1U;
+    buf[2 * i + 1] = phys[BSP_MAX7219_CHAIN - 1U - i][row];
+  }
+}
+
+/**
+ * @brief 同步发送一次突发（一次片选）
+ */
+static RESULT_RUN bsp_max7219_send(const u8 buf[BSP_MAX7219_BURST])
+{
+  if (!BSP_MAX7219_READY)
+    return ERR_RUN_ERROR_UNST;
+
+  /* 异步帧最多 8 次突发（单片约 20us），等它发完再占用总线 */
+  while (BSP_MAX7219_BUSY)
+    ;
+
+  bsp_gpio_Reset(BSP_MAX7219_CS);
+  if (HAL_SPI_Transmit(&BSP_MAX7219_HANDLE, (u8 *)buf, BSP_MAX7219_BURST,
+                       HAL_MAX_DELAY) != HAL_OK)
+  {
+    bsp_gpio_Set(BSP_MAX7219_CS);
+    return ERR_RUN_ERROR_CALL;
+  }
+  bsp_gpio_Set(BSP_MAX7219_CS);
+
+  return ERR_RUN_Finished;
+}
+
+/**
+ * @brief 拉低片选，由 DMA 发出队列中的第 index 行
+ */
+static bool bsp_max7219_tx_start(u8 index)
+{
+  bsp_gpio_Reset(BSP_MAX7219_CS);
+  if (HAL_DMA_Start_IT(&BSP_MAX7219_DMA, (u32)BSP_MAX7219_TX[index],
+                       (u32)&BSP_MAX7219_SPI->DR, BSP_MAX7219_BURST) != HAL_OK)
+  {
+    bsp_gpio_Set(BSP_MAX7219_CS);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 结束异步发送并通知调用者
+ */
+static void bsp_max7219_tx_finish(void)
+{
+  BSP_MAX7219_BUSY = false;
+  if (BSP_MAX7219_DONE != NULL)
+    BSP_MAX7219_DONE();
+}
+
+/**
+ * @brief 一行发完：锁存后接续下一行
+ */
+static void bsp_max7219_tx_cplt_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+
+  bsp_spi_WaitTxDone(&BSP_MAX7219_HANDLE);
+  bsp_gpio_Set(BSP_MAX7219_CS);
+  BSP_MAX7219_STALE &= (u8)~(1U << BSP_MAX7219_TX_ROW[BSP_MAX7219_TX_NEXT]);
+
+  BSP_MAX7219_TX_NEXT++;
+  if (BSP_MAX7219_TX_NEXT < BSP_MAX7219_TX_COUNT &&
+      bsp_max7219_tx_start(BSP_MAX7219_TX_NEXT))
+    return;
+  bsp_max7219_tx_finish();
+}
+
+/**
+ * @brief 传输出错：未发完的行保持待重发
+ */
+static void bsp_max7219_tx_error_cb(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  bsp_gpio_Set(BSP_MAX7219_CS);
+  bsp_max7219_tx_finish();
+}
+
+/**
+ * @brief 一次片选写入各片各自的亮度
+ */
+static RESULT_RUN bsp_max7219_write_intensity(void)
+{
+  u8 buf[BSP_MAX7219_BURST];
+
+  for (u8 i = 0; i < BSP_MAX7219_CHAIN; i++)
+  {
+    buf[2 * i] = 0x0A;
+    buf[2 * i + 1] = BSP_MAX7219_INTENSITY[BSP_MAX7219_CHAIN - 1U - i];
+  }
+  return bsp_max7219_send(buf);
+}
+
+/**
+ * @brief 写入除行寄存器以外的配置
+ */
+static RESULT_RUN bsp_max7219_write_config(void)
+{
+  RESULT_RUN ret = bsp_max7219_set_test_mode(false);
+  if (ret != ERR_RUN_Finished)
+    return ret;
+  ret = bsp_max7219_write_register(0x09, 0x00);
+  if (ret != ERR_RUN_Finished)
+    return ret;
+  ret = bsp_max7219_write_intensity();
+  if (ret != ERR_RUN_Finished)
+    return ret;
+  ret = bsp_max7219_write_register(0x0B, 0x07);
+  if (ret != ERR_RUN_Finished)
+    return ret;
+  return bsp_max7219_write_register(0x0C, 0x01);
+}
 
 RESULT_Init bsp_max7219_init(void)
 {
@@ -23,27 +232,35 @@ RESULT_Init bsp_max7219_init(void)
   if (ret != ERR_Init_Finished)
     return ret;
 
-  HAL_GPIO_WritePin(BSP_MAX7219_GPIOx, BSP_MAX7219_CS_PIN, GPIO_PIN_SET);
+  bsp_gpio_Set(BSP_MAX7219_CS);
 
   ret = bsp_spi_Init(&BSP_MAX7219_HANDLE, BSP_MAX7219_SPI, SPI_MODE_MASTER,
                      SPI_DIRECTION_2LINES, SPI_DATASIZE_8BIT, SPI_POLARITY_LOW,
-                     SPI_PHASE_1EDGE, SPI_NSS_SOFT, SPI_BAUDRATEPRESCALER_32,
+                     SPI_PHASE_1EDGE, SPI_NSS_SOFT, BSP_MAX7219_SPI_PRESCALER,
                      SPI_FIRSTBIT_MSB, SPI_TIMODE_DISABLE,
                      SPI_CRCCALCULATION_DISABLE, 0);
   if (ret != ERR_Init_Finished)
     return ret;
 
+  /* SPI1_TX DMA：每次发送一行（所有片），完成中断里接续 */
+  DMA_Init_Config dma_cfg = bsp_dma_conf_spiTX(BSP_MAX7219_DMA_CHANNEL);
+  ret = bsp_dma_init(&BSP_MAX7219_DMA, &dma_cfg);
+  if (ret != ERR_Init_Finished)
+    return ret;
+  BSP_MAX7219_DMA.XferCpltCallback = bsp_max7219_tx_cplt_cb;
+  BSP_MAX7219_DMA.XferErrorCallback = bsp_max7219_tx_error_cb;
+  bsp_spi_EnableTxDMA(&BSP_MAX7219_HANDLE);
+
+  HAL_NVIC_SetPriority(BSP_MAX7219_DMA_IRQn, BSP_MAX7219_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(BSP_MAX7219_DMA_IRQn);
+
   BSP_MAX7219_READY = true;
 
-  if (bsp_max7219_set_test_mode(false) != ERR_RUN_Finished)
-    return ERR_Init_ERROR_SPI;
-  if (bsp_max7219_write_register(0x09, 0x00) != ERR_RUN_Finished)
-    return ERR_Init_ERROR_SPI;
-  if (bsp_max7219_write_register(0x0A, 0x0F) != ERR_RUN_Finished)
-    return ERR_Init_ERROR_SPI;
-  if (bsp_max7219_write_register(0x0B, 0x07) != ERR_RUN_Finished)
-    return ERR_Init_ERROR_SPI;
-  if (bsp_max7219_write_register(0x0C, 0x01) != ERR_RUN_Finished)
+  /* 上电后行寄存器内容未知，全部重写一次 */
+  for (u8 dev = 0; dev < BSP_MAX7219_CHAIN; dev++)
+    BSP_MAX7219_INTENSITY[dev] = 0x0F;
+  BSP_MAX7219_STALE = 0xFF;
+  if (bsp_max7219_write_config() != ERR_RUN_Finished)
     return ERR_Init_ERROR_SPI;
   if (bsp_max7219_clear() != ERR_RUN_Finished)
     return ERR_Init_ERROR_SPI;
@@ -53,54 +270,166 @@ RESULT_Init bsp_max7219_init(void)
 
 RESULT_RUN bsp_max7219_write_register(u8 addr, u8 data)
 {
-  u8 buf[2] = {addr, data};
+  u8 buf[BSP_MAX7219_BURST];
+
+  for (u8 i = 0; i < BSP_MAX7219_CHAIN; i++)
+  {
+    buf[2 * i] = addr;
+    buf[2 * i + 1] = data;
+  }
+  return bsp_max7219_send(buf);
+}
+
+u8 *bsp_max7219_getFrame(void) { return &BSP_MAX7219_FRAME[0][0]; }
+
+RESULT_RUN bsp_max7219_flush(void)
+{
+  u8 phys[BSP_MAX7219_CHAIN][8];
+  u8 buf[BSP_MAX7219_BURST];
 
   if (!BSP_MAX7219_READY)
     return ERR_RUN_ERROR_UNST;
 
-  HAL_GPIO_WritePin(BSP_MAX7219_GPIOx, BSP_MAX7219_CS_PIN, GPIO_PIN_RESET);
-  if (HAL_SPI_Transmit(&BSP_MAX7219_HANDLE, buf, 2, HAL_MAX_DELAY) != HAL_OK)
+  /* 影子与待重发位也由异步发送的中断改写，先等它结束 */
+  while (BSP_MAX7219_BUSY)
+    ;
+
+  u8 mask = bsp_max7219_diff(phys);
+  for (u8 row = 0; row < 8; row++)
   {
-    HAL_GPIO_WritePin(BSP_MAX7219_GPIOx, BSP_MAX7219_CS_PIN, GPIO_PIN_SET);
-    return ERR_RUN_ERROR_CALL;
+    if ((mask & (1U << row)) == 0U)
+      continue;
+
+    bsp_max7219_pack_row(row, phys, buf);
+    RESULT_RUN ret = bsp_max7219_send(buf);
+    if (ret != ERR_RUN_Finished)
+      return ret;
+    BSP_MAX7219_STALE &= (u8)~(1U << row);
   }
-  HAL_GPIO_WritePin(BSP_MAX7219_GPIOx, BSP_MAX7219_CS_PIN, GPIO_PIN_SET);
 
   return ERR_RUN_Finished;
 }
 
 RESULT_RUN bsp_max7219_write_rows(const u8 rows[8])
 {
-  u8 row = 0;
-
   if (rows == NULL)
     return ERR_RUN_ERROR_UDIP;
 
-  for (row = 1; row <= 8; row++)
+  while (BSP_MAX7219_BUSY)
+    ;
+  memcpy(BSP_MAX7219_FRAME[0], rows, 8);
+  return bsp_max7219_flush();
+}
+
+RESULT_RUN bsp_max7219_submit(void)
+{
+  u8 phys[BSP_MAX7219_CHAIN][8];
+  u8 count = 0;
+
+  if (!BSP_MAX7219_READY)
+    return ERR_RUN_ERROR_UNST;
+  if (BSP_MAX7219_BUSY)
+    return ERR_RUN_BUSY;
+
+  /* 发送队列只放有变化或待重发的行，每行发完时清除待重发位 */
+  u8 mask = bsp_max7219_diff(phys);
+  for (u8 row = 0; row < 8; row++)
   {
-    RESULT_RUN ret = bsp_max7219_write_register(row, rows[row - 1]);
-    if (ret != ERR_RUN_Finished)
-      return ret;
+    if ((mask & (1U << row)) == 0U)
+      continue;
+    bsp_max7219_pack_row(row, phys, BSP_MAX7219_TX[count]);
+    BSP_MAX7219_TX_ROW[count] = row;
+    count++;
   }
+  if (count == 0U)
+    return ERR_RUN_Finished;
 
+  BSP_MAX7219_TX_COUNT = count;
+  BSP_MAX7219_TX_NEXT = 0;
+  BSP_MAX7219_BUSY = true;
+  if (!bsp_max7219_tx_start(0))
+  {
+    BSP_MAX7219_BUSY = false;
+    return ERR_RUN_ERROR_CALL;
+  }
   return ERR_RUN_Finished;
 }
 
+RESULT_RUN bsp_max7219_submit_rows(const u8 rows[8])
+{
+  if (rows == NULL)
+    return ERR_RUN_ERROR_UDIP;
+  if (BSP_MAX7219_BUSY)
+    return ERR_RUN_BUSY;
+
+  memcpy(BSP_MAX7219_FRAME[0], rows, 8);
+  return bsp_max7219_submit();
+}
+
+bool bsp_max7219_busy(void) { return BSP_MAX7219_BUSY; }
+
+void bsp_max7219_set_done_cb(bsp_max7219_done_fn fn) { BSP_MAX7219_DONE = fn; }
+
+DMA_HandleTypeDef *bsp_max7219_getDMAHandle(void)
+{
+  return BSP_MAX7219_READY ? &BSP_MAX7219_DMA : NULL;
+}
+
 RESULT_RUN bsp_max7219_clear(void)
 {
-  u8 row = 0;
+  while (BSP_MAX7219_BUSY)
+    ;
+  memset(BSP_MAX7219_FRAME, 0, sizeof(BSP_MAX7219_FRAME));
+  return bsp_max7219_flush();
+}
 
-  for (row = 1; row <= 8; row++)
-  {
-    RESULT_RUN ret = bsp_max7219_write_register(row, 0x00);
-    if (ret != ERR_RUN_Finished)
-      return ret;
-  }
+RESULT_RUN bsp_max7219_refresh(void)
+{
+  RESULT_RUN ret = ERR_RUN_Finished;
 
-  return ERR_RUN_Finished;
+  if (!BSP_MAX7219_READY)
+    return ERR_RUN_ERROR_UNST;
+
+  ret = bsp_max7219_write_config();
+  if (ret != ERR_RUN_Finished)
+    return ret;
+
+  /* write_config 已等待异步发送结束 */
+  BSP_MAX7219_STALE = 0xFF;
+  return bsp_max7219_flush();
 }
 
 RESULT_RUN bsp_max7219_set_test_mode(bool enable)
 {
   return bsp_max7219_write_register(0x0F, enable ? 0x01 : 0x00);
 }
+
+/**
+ * @note intensity 为亮度寄存器值 0~15（占空比 (2n+1)/32），
+ * 按感知亮度设置时先经 app_lut_max7219 查表
+ */
+RESULT_RUN bsp_max7219_set_intensity(u8 intensity)
+{
+  for (u8 dev = 0; dev < BSP_MAX7219_CHAIN; dev++)
+    BSP_MAX7219_INTENSITY[dev] = intensity & 0x0FU;
+  return bsp_max7219_write_intensity();
+}
+
+RESULT_RUN bsp_max7219_set_intensity_dev(u8 dev, u8 intensity)
+{
+  if (dev >= BSP_MAX7219_CHAIN)
+    return ERR_RUN_ERROR_ERIP;
+
+  BSP_MAX7219_INTENSITY[dev] = intensity & 0x0FU;
+  return bsp_max7219_write_intensity();
+}
+
+RESULT_RUN bsp_max7219_set_rotation(u8 dev, u8 turns)
+{
+  if (dev >= BSP_MAX7219_CHAIN)
+    return ERR_RUN_ERROR_ERIP;
+
+  /* 影子保存旋转后的数据，下一次发送时自然比较出变化的行 */
+  BSP_MAX7219_ROTATION[dev] = turns & 0x03U;
+  return ERR_RUN_Finished;
+}
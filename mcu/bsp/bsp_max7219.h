@@ -9,6 +9,7 @@
 #include "ERR.h"
 #include "__port_type__.h"
 #include "stm32f103xb.h"
+#include "stm32f1xx_hal_dma.h"
 #include <stdbool.h>
 
 #define BSP_MAX7219_GPIOx GPIOA
@@ -16,11 +17,69 @@
 #define BSP_MAX7219_CLK_PIN GPIO_PIN_5
 #define BSP_MAX7219_CS_PIN GPIO_PIN_4
 #define BSP_MAX7219_SPI SPI1
+/* APB2 72MHz / 8 = 9MHz，不超过 MAX7219 的 10MHz */
+#define BSP_MAX7219_SPI_PRESCALER SPI_BAUDRATEPRESCALER_8
+#define BSP_MAX7219_DMA_CHANNEL DMA1_Channel3 /* SPI1_TX */
+#define BSP_MAX7219_DMA_IRQn DMA1_Channel3_IRQn
+#define BSP_MAX7219_IRQ_PRIORITY 5 /* 不小于 configMAX_SYSCALL_INTERRUPT_PRIORITY */
+
+/**
+ * 级联的 MAX7219 数量（1~8），共用一个 CS。
+ * 第 0 片直接接 MCU 的 DIN，后面各片的 DIN 接前一片的 DOUT。
+ */
+#ifndef BSP_MAX7219_CHAIN
+#define BSP_MAX7219_CHAIN 1U
+#endif
+
+#if (BSP_MAX7219_CHAIN < 1U) || (BSP_MAX7219_CHAIN > 8U)
+#error "BSP_MAX7219_CHAIN must be 1..8"
+#endif
+
+/* 帧缓冲区字节数：每片 8 行，第 dev 片的第 row 行位于 [dev * 8 + row] */
+#define BSP_MAX7219_FRAME_BYTES (8U * BSP_MAX7219_CHAIN)
+
+/* 异步发送完成回调，在 DMA 中断中调用 */
+typedef void (*bsp_max7219_done_fn)(void);
 
 RESULT_Init bsp_max7219_init(void);
+/* 向级联的每一片写同一个寄存器（一次片选） */
 RESULT_RUN bsp_max7219_write_register(u8 addr, u8 data);
+
+/**
+ * 帧缓冲区按逻辑方向保存图案，发送时按每片的旋转设置换算。
+ * 同一行在所有片上的寄存器在一次片选内发出，整链刷新为 8 次突发；
+ * 驱动保存行寄存器影子，只发送有变化的行。
+ */
+u8 *bsp_max7219_getFrame(void);
+/* 同步发送帧缓冲区中有变化的行 */
+RESULT_RUN bsp_max7219_flush(void);
+/* 写入第 0 片的 8 行后同步发送，兼容单片用法 */
 RESULT_RUN bsp_max7219_write_rows(const u8 rows[8]);
+/* 清空帧缓冲区并同步发送 */
 RESULT_RUN bsp_max7219_clear(void);
+/* 强制按影子重写全部配置与行寄存器，用于干扰后恢复 */
+RESULT_RUN bsp_max7219_refresh(void);
+
+/**
+ * 异步提交帧缓冲区：有变化的行由 SPI1_TX DMA 逐行发出，每行发完在 DMA
+ * 中断里拉高片选锁存，再启动下一行；全部发完调用完成回调。
+ * 提交时已把数据复制到发送队列，返回后即可改写帧缓冲区。
+ * 上一帧未发完时返回 ERR_RUN_BUSY；没有变化的行时直接返回，不调用回调。
+ * 同步接口（write_register 等）会先等待正在发送的帧结束。
+ */
+RESULT_RUN bsp_max7219_submit(void);
+/* 写入第 0 片的 8 行后异步提交 */
+RESULT_RUN bsp_max7219_submit_rows(const u8 rows[8]);
+bool bsp_max7219_busy(void);
+void bsp_max7219_set_done_cb(bsp_max7219_done_fn fn);
+DMA_HandleTypeDef *bsp_max7219_getDMAHandle(void);
+
 RESULT_RUN bsp_max7219_set_test_mode(bool enable);
+/* 所有片设为同一亮度 */
+RESULT_RUN bsp_max7219_set_intensity(u8 intensity);
+/* 单片亮度，一次片选写入所有片各自的亮度 */
+RESULT_RUN bsp_max7219_set_intensity_dev(u8 dev, u8 intensity);
+/* 单片旋转（顺时针 90° 的次数，0~3），下一次发送时生效 */
+RESULT_RUN bsp_max7219_set_rotation(u8 dev, u8 turns);
 
 #endif
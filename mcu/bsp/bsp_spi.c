@@ -49,4 +49,21 @@ RESULT_Init bsp_spi_Init(SPI_HandleTypeDef *hspi, SPI_TypeDef *SPIx, u32 Mode,
   hspi->Init.CRCPolynomial = CRCPolynomial;
 
   return HAL_SPI_Init(hspi) ? ERR_Init_ERROR_SPI : ERR_Init_Finished;
+}
+
+void bsp_spi_EnableTxDMA(SPI_HandleTypeDef *hspi)
+{
+  __HAL_SPI_ENABLE(hspi);
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN);
+}
+
+void bsp_spi_WaitTxDone(SPI_HandleTypeDef *hspi)
+{
+  SPI_TypeDef *spi = hspi->Instance;
+
+  while ((spi->SR & SPI_SR_TXE) == 0U)
+    ;
+  while ((spi->SR & SPI_SR_BSY) != 0U)
+    ;
+  __HAL_SPI_CLEAR_OVRFLAG(hspi);
 }
\ No newline at end of file
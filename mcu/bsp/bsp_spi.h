@@ -79,4 +79,20 @@ RESULT_Init bsp_spi_Init(SPI_HandleTypeDef *hspi, SPI_TypeDef *SPIx, u32 Mode,
                          u32 FirstBit, u32 TIMode, u32 CRCCalculation,
                          u32 CRCPolynomial);
 
+/**
+ * @brief 打开 SPI 发送 DMA 请求
+ * @param hspi	已初始化的 SPI 句柄
+ * @note  同时使能 SPI，之后 DMA 通道一启动就开始发送
+ */
+void bsp_spi_EnableTxDMA(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief 等待最后一帧移出总线
+ * @param hspi	SPI 句柄
+ * @note
+ * DMA 传输完成时最后一个字节刚写入 DR，还没有发出；等 TXE 置位、BSY
+ * 清零后才能释放片选。全双工只发不收时顺带清除接收溢出标志。
+ */
+void bsp_spi_WaitTxDone(SPI_HandleTypeDef *hspi);
+
 #endif
@@ -28,6 +28,8 @@ typedef enum
   SIG_DISPLAY_UPDATE = (1 << 1),    /* 显示状态已更新 */
   SIG_CAN_RX         = (1 << 2),    /* 收到有效 CAN 报文 */
   SIG_RESERVED_USER  = (1 << 3),    /* 预留给用户交互来源 */
+  SIG_ANIM_FRAME     = (1 << 4),    /* 动画帧节拍（app_anim 定时器） */
+  SIG_SCROLL_FRAME   = (1 << 5),    /* 滚动文字帧节拍（app_dot_scroll 定时器） */
 
 } system_signal_t;
 // clang-format on
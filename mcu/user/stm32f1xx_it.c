@@ -1,6 +1,10 @@
 
 #include "FreeRTOS.h"
+#include "app_debug.h"
 #include "app_gonio.h"
+#include "app_gonio_spi.h"
+#include "app_leds.h"
+#include "bsp_max7219.h"
 #include "task.h"
 
 void xPortSysTickHandler(void);
@@ -40,6 +44,59 @@ void HardFault_Handler(void)
 /* 定时器3中断函数 */
 void TIM3_IRQHandler(void) { HAL_TIM_IRQHandler(app_gonio_getTIMHandle()); }
 
+/* 串口1中断函数（调试命令行接收） */
+void USART1_IRQHandler(void) { app_debug_dispose_ISP(); }
+
+/* DMA1 通道6中断函数（角度捕获 DMA 模式） */
+void DMA1_Channel6_IRQHandler(void)
+{
+  DMA_HandleTypeDef *hdma = app_gonio_getDMAHandle();
+  if (hdma != NULL)
+    HAL_DMA_IRQHandler(hdma);
+}
+
+/* DMA1 通道3中断函数（点阵 SPI1 发送） */
+void DMA1_Channel3_IRQHandler(void)
+{
+  DMA_HandleTypeDef *hdma = bsp_max7219_getDMAHandle();
+  if (hdma != NULL)
+    HAL_DMA_IRQHandler(hdma);
+}
+
+/* DMA1 通道4中断函数（SPI 角度源接收） */
+void DMA1_Channel4_IRQHandler(void)
+{
+  DMA_HandleTypeDef *hdma = app_gonio_spi_getDMAHandle();
+  if (hdma != NULL)
+    HAL_DMA_IRQHandler(hdma);
+}
+
+/* DMA1 通道5中断函数（灯带位波形） */
+void DMA1_Channel5_IRQHandler(void)
+{
+  DMA_HandleTypeDef *hdma = app_leds_getDMAHandle();
+  if (hdma != NULL)
+    HAL_DMA_IRQHandler(hdma);
+}
+
+/* 定时器 DMA 捕获半传输回调函数 */
+void HAL_TIM_IC_CaptureHalfCpltCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim != NULL && htim == app_gonio_getTIMHandle())
+  {
+    app_gonio_dispose_ISP();
+  }
+}
+
+/* 定时器更新（计数溢出）回调函数 */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim != NULL && htim == app_gonio_getTIMHandle())
+  {
+    app_gonio_dispose_OVF_ISP();
+  }
+}
+
 /* 定时器中断回调函数 */
 void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
 {
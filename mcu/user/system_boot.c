@@ -9,6 +9,7 @@
 #include "app_debug.h"
 #include "app_dot_displayer.h"
 #include "app_gonio.h"
+#include "app_leds.h"
 #include "app_state.h"
 #include "app_trun_lamp.h"
 #include "event_bus.h"
@@ -23,6 +24,12 @@ static void Task_Angle(void *arg)
   app_gonio_dispose_Task();
 }
 
+static void Task_Debug(void *arg)
+{
+  (void)arg;
+  app_debug_dispose_Task();
+}
+
 static void Task_Trun(void *arg)
 {
   (void)arg;
@@ -107,6 +114,12 @@ RESULT_Init system_boot_run(void)
   if (ret != ERR_Init_Finished)
     goto boot_fail;
 
+#if APP_LEDS_ENABLE
+  ret = app_leds_init();
+  if (ret != ERR_Init_Finished)
+    goto boot_fail;
+#endif
+
   ret = app_gonio_init();
   if (ret != ERR_Init_Finished)
     goto boot_fail;
@@ -135,6 +148,10 @@ RESULT_Init system_boot_run(void)
   if (ret != ERR_Init_Finished)
     goto boot_fail;
 
+  ret = system_boot_create_task(Task_Debug, "Debug", 256);
+  if (ret != ERR_Init_Finished)
+    goto boot_fail;
+
   return ERR_Init_Finished;
 
 boot_fail:
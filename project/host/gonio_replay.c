@@ -0,0 +1,480 @@
+/**
+ * @file		gonio_replay.c
+ * @brief		主机工具：角度捕获序列回放
+ * @note		把录制/合成的 {t_us, period, high} 序列送入 app_gonio_core，
+ *					报告检测到的转向状态、相对理想判定的延时与每样本耗时
+ * @author	王广平
+ *
+ * @note
+ * 1) 回放按固件的线程模型进行，而不是逐样本调用状态机：
+ *    - “中断”侧：每次捕获解码并多圈展开，每 GONIO_NOTIFY_DECIMATE 次检查
+ *      高电平变化是否超过死区，超过才唤醒线程（同 app_gonio_dispose_ISP）
+ *    - 线程侧：被唤醒或等待超时（app_gonio_core_wait_ms）时取最新一次捕获，
+ *      滤波、估计角速度、走一步状态机（同 app_gonio_dispose_Task）
+ *    因此方向盘静止、没有通知时的超时行为也能回放出来。
+ * 2) 延时：第 k 次理想状态变化（truth 列）与落在它前后两次变化之间、
+ *    第一次提交到同一状态的检测结果配对，差值为延时，预测提前提交时为负；
+ *    没有配对的检测结果计为误触发。
+ * 3) 标准输出只包含确定性的结果，可与期望文件逐字比较；耗时打印到 stderr。
+ */
+
+/* 头文件引用 */
+#include "app_gonio_core.h"
+#include "gonio_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 线程模型参数（通知抽取、死区、无数据等待）直接使用 app_gonio_core.h 中固件的默认值 */
+#define REPLAY_SPIN_MAX 8U           /* 同一毫秒内被唤醒超过该次数视为空转 */
+#define REPLAY_BENCH_SAMPLES 2000000U
+
+/* 一次状态提交 */
+typedef struct
+{
+  u32 t_ms;
+  app_steer_state_t from;
+  app_steer_state_t to;
+  bool predicted;
+  s32 angle;
+  s32 vel;
+} replay_event_t;
+
+/* 回放配置 */
+typedef struct
+{
+  app_gonio_param_t param;
+  bool use_low;    /* 按低电平宽度解码 */
+  bool fixed_zero; /* 使用给定的 0 点，否则第一次有效角度自动校零 */
+  s32 zero_cdeg;
+  u32 decimate;
+  u32 deadband; /* 单位：tick */
+} replay_cfg_t;
+
+/* 回放状态 */
+typedef struct
+{
+  const replay_cfg_t *cfg;
+
+  /* 中断侧：多圈展开与最新一次捕获 */
+  app_gonio_unwrap_t unwrap;
+  u32 seq;
+  s32 cap_abs;
+  s32 cap_base;
+  s32 cap_acc;
+  u32 cap_t_us;
+  u32 notify_cnt;
+  u32 notify_high;
+
+  /* 线程侧 */
+  app_gonio_core_t core;
+  u32 rd_seq;
+  bool zero_inited;
+  s32 zero_cdeg;
+  bool has_angle;
+  s32 angle;
+  u32 sample_us;
+  u32 last_sample_ms;
+  u32 deadline_ms; /* 超时唤醒时刻 */
+  u32 spin_ms;
+  u32 spin_cnt;
+
+  /* 结果 */
+  replay_event_t *ev; /* NULL 时不记录（测耗时） */
+  u32 ev_count;
+  u32 ev_cap;
+  u32 wakes;
+  u32 timeouts;
+  u32 spins;
+} replay_t;
+
+static const char *replay_state_name(int s)
+{
+  switch (s)
+  {
+  case APP_STEER_CENTER:
+    return "CENTER";
+  case APP_STEER_LEFT:
+    return "LEFT";
+  case APP_STEER_RIGHT:
+    return "RIGHT";
+  default:
+    return "?";
+  }
+}
+
+/**
+ * @brief 打印带符号的 cdeg 值（xx.xx）
+ */
+static void replay_print_cdeg(s32 cdeg)
+{
+  s32 mag = (cdeg < 0) ? -cdeg : cdeg;
+  printf("%s%ld.%02ld", (cdeg < 0) ? "-" : "", (long)(mag / 100),
+         (long)(mag % 100));
+}
+
+static void replay_record(replay_t *r, app_steer_state_t from, u32 now_ms)
+{
+  if (r->ev == NULL)
+    return;
+  if (r->ev_count == r->ev_cap)
+  {
+    u32 cap = r->ev_cap ? 2U * r->ev_cap : 64U;
+    replay_event_t *ev = realloc(r->ev, cap * sizeof(*ev));
+    if (ev == NULL)
+      return;
+    r->ev = ev;
+    r->ev_cap = cap;
+  }
+
+  replay_event_t *e = &r->ev[r->ev_count++];
+  e->t_ms = now_ms;
+  e->from = from;
+  e->to = r->core.state;
+  e->predicted = r->core.predicted;
+  e->angle = r->angle;
+  e->vel = r->core.vel;
+}
+
+/**
+ * @brief 线程被唤醒一次（通知或超时）
+ */
+static void replay_task(replay_t *r, u32 now_ms)
+{
+  const replay_cfg_t *cfg = r->cfg;
+  bool got = false;
+
+  /* 空转保护：同一毫秒内反复被唤醒说明等待时间一直为 0 */
+  if (now_ms == r->spin_ms)
+  {
+    if (++r->spin_cnt > REPLAY_SPIN_MAX)
+    {
+      r->spins++;
+      r->deadline_ms = now_ms + 1U;
+      return;
+    }
+  }
+  else
+  {
+    r->spin_ms = now_ms;
+    r->spin_cnt = 0;
+  }
+  r->wakes++;
+
+  /* 取最新一次捕获（同 app_gonio_GetAngleCdeg） */
+  if (r->seq != r->rd_seq)
+  {
+    r->rd_seq = r->seq;
+    if (r->cap_abs >= 0)
+    {
+      r->sample_us = r->cap_t_us;
+      r->last_sample_ms = now_ms;
+      if (!r->zero_inited)
+      {
+        r->zero_inited = true;
+        r->zero_cdeg = r->cap_abs;
+      }
+      else
+      {
+        r->angle = app_gonio_core_filter(
+            &r->core,
+            app_gonio_core_unwrap_rel(r->cap_base, r->cap_acc, r->zero_cdeg));
+        got = true;
+      }
+    }
+  }
+
+  if (got)
+  {
+    r->has_angle = true;
+    app_gonio_core_velocity(&r->core, r->angle, r->sample_us);
+  }
+  else if (r->has_angle &&
+           (now_ms - r->last_sample_ms) > cfg->param.hold_ms)
+  {
+    r->has_angle = false;
+  }
+
+  if (!r->has_angle)
+  {
+    app_gonio_core_reset(&r->core);
+    r->deadline_ms = now_ms + GONIO_NODATA_MS;
+    return;
+  }
+
+  app_steer_state_t from = r->core.state;
+  if (app_gonio_core_step(&r->core, &cfg->param, r->angle, now_ms))
+    replay_record(r, from, now_ms);
+
+  r->deadline_ms =
+      now_ms + app_gonio_core_wait_ms(&r->core, &cfg->param, now_ms,
+                                      GONIO_NODATA_MS);
+}
+
+/**
+ * @brief 一次捕获（同 app_gonio_dispose_ISP 的中断模式）
+ */
+static void replay_capture(replay_t *r, const gonio_trace_row_t *row)
+{
+  const replay_cfg_t *cfg = r->cfg;
+
+  s32 abs_cdeg = app_gonio_core_decode(row->period, row->high, cfg->use_low);
+  bool ok = app_gonio_core_unwrap(&r->unwrap, abs_cdeg, row->t_us);
+
+  r->seq++;
+  r->cap_abs = ok ? abs_cdeg : -1;
+  r->cap_base = r->unwrap.base_abs;
+  r->cap_acc = r->unwrap.acc;
+  r->cap_t_us = row->t_us;
+
+  if (++r->notify_cnt >= cfg->decimate)
+  {
+    u32 diff = (row->high > r->notify_high) ? (row->high - r->notify_high)
+                                            : (r->notify_high - row->high);
+    r->notify_cnt = 0;
+    if (diff >= cfg->deadband)
+    {
+      r->notify_high = row->high;
+      replay_task(r, row->t_us / 1000U);
+    }
+  }
+}
+
+/**
+ * @brief 回放整段序列
+ * @param record 是否记录状态提交
+ */
+static void replay_run(replay_t *r, const replay_cfg_t *cfg,
+                       const gonio_trace_t *t, bool record)
+{
+  memset(r, 0, sizeof(*r));
+  r->cfg = cfg;
+  r->spin_ms = 0xFFFFFFFFUL;
+  app_gonio_core_unwrap_init(&r->unwrap);
+  app_gonio_core_init(&r->core);
+  r->zero_inited = cfg->fixed_zero;
+  r->zero_cdeg = cfg->zero_cdeg;
+  r->deadline_ms = t->rows[0].t_us / 1000U + GONIO_NODATA_MS;
+  if (record)
+  {
+    r->ev_cap = 64U;
+    r->ev = malloc(r->ev_cap * sizeof(*r->ev));
+  }
+
+  for (u32 i = 0; i < t->count; i++)
+  {
+    const gonio_trace_row_t *row = &t->rows[i];
+
+    /* 本次捕获之前到期的超时唤醒 */
+    while ((u64)r->deadline_ms * 1000U <= row->t_us)
+    {
+      r->timeouts++;
+      replay_task(r, r->deadline_ms);
+    }
+    replay_capture(r, row);
+  }
+}
+
+/**
+ * @brief 与理想判定配对并打印延时
+ */
+static void replay_report(const replay_t *r, const gonio_trace_t *t)
+{
+  u32 *truth_ms = malloc(t->count * sizeof(u32));
+  s8 *truth_to = malloc(t->count);
+  bool *used = calloc(r->ev_count + 1U, sizeof(bool));
+  u32 n = 0;
+  u32 matched = 0;
+  s64 sum = 0;
+  s32 max = 0;
+
+  if (truth_ms == NULL || truth_to == NULL || used == NULL)
+    goto out;
+
+  for (u32 i = 1; i < t->count; i++)
+  {
+    if (t->rows[i].truth != t->rows[i - 1U].truth)
+    {
+      truth_ms[n] = t->rows[i].t_us / 1000U;
+      truth_to[n] = t->rows[i].truth;
+      n++;
+    }
+  }
+
+  for (u32 k = 0; k < n; k++)
+  {
+    u32 lo = (k == 0U) ? 0U : truth_ms[k - 1U];
+    u32 hi = (k + 1U == n) ? 0xFFFFFFFFUL : truth_ms[k + 1U];
+    u32 j = 0;
+
+    for (j = 0; j < r->ev_count; j++)
+    {
+      const replay_event_t *e = &r->ev[j];
+      if (!used[j] && (int)e->to == truth_to[k] && e->t_ms > lo &&
+          e->t_ms < hi)
+        break;
+    }
+
+    printf("truth %6lu ms  %-6s  ", (unsigned long)truth_ms[k],
+           replay_state_name(truth_to[k]));
+    if (j == r->ev_count)
+    {
+      printf("missed\n");
+      continue;
+    }
+
+    s32 lat = (s32)(r->ev[j].t_ms - truth_ms[k]);
+    used[j] = true;
+    matched++;
+    sum += lat;
+    if (matched == 1U || lat > max)
+      max = lat;
+    printf("detected %6lu ms  latency %+ld ms%s\n",
+           (unsigned long)r->ev[j].t_ms, (long)lat,
+           r->ev[j].predicted ? " (predicted)" : "");
+  }
+
+  u32 spurious = 0;
+  for (u32 j = 0; j < r->ev_count; j++)
+    spurious += used[j] ? 0U : 1U;
+
+  printf("summary: detected=%lu truth=%lu matched=%lu missed=%lu "
+         "spurious=%lu",
+         (unsigned long)r->ev_count, (unsigned long)n,
+         (unsigned long)matched, (unsigned long)(n - matched),
+         (unsigned long)spurious);
+  if (matched != 0U)
+    printf(" latency mean=%+ld max=%+ld ms", (long)(sum / (s64)matched),
+           (long)max);
+  printf("\n");
+
+out:
+  free(truth_ms);
+  free(truth_to);
+  free(used);
+}
+
+static double replay_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void replay_usage(void)
+{
+  fprintf(stderr,
+          "usage: gonio_replay [-l] [-z zero_cdeg] [-n decimate] "
+          "[-d deadband_ticks] [-r runs] trace.csv\n"
+          "  -l  decode the low-time width\n"
+          "  -z  fixed zero point (default: first valid angle)\n"
+          "  -n  notify every n captures (default %u)\n"
+          "  -d  notify deadband in ticks (default %uus at tick_hz)\n"
+          "  -r  timing runs, 0 = skip (default: about %u samples)\n",
+          GONIO_NOTIFY_DECIMATE, GONIO_NOTIFY_DEADBAND_US,
+          REPLAY_BENCH_SAMPLES);
+}
+
+int main(int argc, char *argv[])
+{
+  replay_cfg_t cfg = {
+      .param =
+          {
+              .turn_on_cdeg = GONIO_TURN_ON_CDEG,
+              .center_cdeg = GONIO_CENTER_CDEG,
+              .hyst_cdeg = GONIO_HYST_CDEG,
+              .turn_ms = GONIO_TURN_MS,
+              .center_ms = GONIO_CENTER_MS,
+              .hold_ms = GONIO_HOLD_MS,
+              .predict_ms = GONIO_PREDICT_STABLE_MS,
+              .confirm_ms = GONIO_PREDICT_CONFIRM_MS,
+          },
+      .decimate = GONIO_NOTIFY_DECIMATE,
+  };
+  long deadband = -1;
+  long runs = -1;
+  gonio_trace_t t;
+  replay_t r;
+  int opt = 0;
+
+  while ((opt = getopt(argc, argv, "lz:n:d:r:h")) != -1)
+  {
+    switch (opt)
+    {
+    case 'l':
+      cfg.use_low = true;
+      break;
+    case 'z':
+      cfg.fixed_zero = true;
+      cfg.zero_cdeg = (s32)strtol(optarg, NULL, 10);
+      break;
+    case 'n':
+      cfg.decimate = (u32)strtoul(optarg, NULL, 10);
+      break;
+    case 'd':
+      deadband = strtol(optarg, NULL, 10);
+      break;
+    case 'r':
+      runs = strtol(optarg, NULL, 10);
+      break;
+    default:
+      replay_usage();
+      return 2;
+    }
+  }
+  if (optind + 1 != argc || cfg.decimate == 0U)
+  {
+    replay_usage();
+    return 2;
+  }
+  if (!gonio_trace_load(argv[optind], &t))
+    return 1;
+
+  cfg.deadband = (deadband >= 0)
+                     ? (u32)deadband
+                     : (u32)((u64)GONIO_NOTIFY_DEADBAND_US * t.tick_hz /
+                             1000000U);
+
+  const char *name = strrchr(argv[optind], '/');
+  name = (name != NULL) ? name + 1 : argv[optind];
+  printf("trace %s: %lu samples, tick_hz=%lu, notify=1/%lu deadband=%lu, "
+         "median=%u iir=%u\n",
+         name, (unsigned long)t.count, (unsigned long)t.tick_hz,
+         (unsigned long)cfg.decimate, (unsigned long)cfg.deadband,
+         (unsigned)GONIO_FILTER_MEDIAN_N, (unsigned)GONIO_FILTER_IIR_SHIFT);
+
+  replay_run(&r, &cfg, &t, true);
+  for (u32 i = 0; i < r.ev_count; i++)
+  {
+    const replay_event_t *e = &r.ev[i];
+    printf("%6lu ms  %-6s -> %-6s rel=", (unsigned long)e->t_ms,
+           replay_state_name(e->from), replay_state_name(e->to));
+    replay_print_cdeg(e->angle);
+    printf(" vel=%ld%s\n", (long)e->vel, e->predicted ? " (predicted)" : "");
+  }
+  printf("wakes=%lu timeouts=%lu spins=%lu unwrap_rej=%lu\n",
+         (unsigned long)r.wakes, (unsigned long)r.timeouts,
+         (unsigned long)r.spins, (unsigned long)r.unwrap.rejects);
+  if (t.has_truth)
+    replay_report(&r, &t);
+  free(r.ev);
+
+  /* 耗时：不记录事件，重复回放到约 REPLAY_BENCH_SAMPLES 个样本 */
+  if (runs < 0)
+    runs = (long)((REPLAY_BENCH_SAMPLES + t.count - 1U) / t.count);
+  if (runs > 0)
+  {
+    double t0 = replay_now_ns();
+    for (long i = 0; i < runs; i++)
+      replay_run(&r, &cfg, &t, false);
+    double ns = (replay_now_ns() - t0) / ((double)runs * t.count);
+    fprintf(stderr,
+            "cost: %.1f ns/sample, %.1f Msamples/s (%lu samples x %ld runs)\n",
+            ns, 1e3 / ns, (unsigned long)t.count, runs);
+  }
+
+  gonio_trace_free(&t);
+  return 0;
+}
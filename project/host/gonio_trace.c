@@ -0,0 +1,115 @@
+/**
+ * @file		gonio_trace.c
+ * @brief		用于定义操作该模块的函数
+ * @note		主机工具：读取录制/合成的角度捕获序列（CSV）
+ * @author	王广平
+ */
+
+/* 头文件引用 */
+#include "gonio_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static s8 gonio_trace_state(char c)
+{
+  switch (c)
+  {
+  case 'C':
+    return APP_STEER_CENTER;
+  case 'L':
+    return APP_STEER_LEFT;
+  case 'R':
+    return APP_STEER_RIGHT;
+  default:
+    return -1;
+  }
+}
+
+bool gonio_trace_load(const char *path, gonio_trace_t *out)
+{
+  FILE *f = fopen(path, "r");
+  char line[256];
+  u32 cap = 4096;
+  u32 lineno = 0;
+
+  if (f == NULL)
+  {
+    fprintf(stderr, "%s: cannot open\n", path);
+    return false;
+  }
+
+  memset(out, 0, sizeof(*out));
+  out->rows = malloc(cap * sizeof(out->rows[0]));
+  out->has_truth = true;
+  if (out->rows == NULL)
+  {
+    fclose(f);
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    unsigned long t = 0;
+    unsigned long period = 0;
+    unsigned long high = 0;
+    char truth = 0;
+
+    lineno++;
+    if (line[0] == '#')
+    {
+      const char *k = strstr(line, "tick_hz=");
+      if (k != NULL)
+        out->tick_hz = (u32)strtoul(k + 8, NULL, 10);
+      continue;
+    }
+    if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0')
+      continue;
+
+    int n = sscanf(line, "%lu,%lu,%lu,%c", &t, &period, &high, &truth);
+    if (n < 3)
+    {
+      fprintf(stderr, "%s:%lu: bad line\n", path, (unsigned long)lineno);
+      fclose(f);
+      gonio_trace_free(out);
+      return false;
+    }
+
+    if (out->count == cap)
+    {
+      gonio_trace_row_t *r = realloc(out->rows, 2U * cap * sizeof(*r));
+      if (r == NULL)
+      {
+        fclose(f);
+        gonio_trace_free(out);
+        return false;
+      }
+      out->rows = r;
+      cap *= 2U;
+    }
+
+    gonio_trace_row_t *row = &out->rows[out->count++];
+    row->t_us = (u32)t;
+    row->period = (u32)period;
+    row->high = (u32)high;
+    row->truth = (n == 4) ? gonio_trace_state(truth) : -1;
+    if (row->truth < 0)
+      out->has_truth = false;
+  }
+
+  fclose(f);
+  if (out->count == 0U)
+  {
+    fprintf(stderr, "%s: no samples\n", path);
+    gonio_trace_free(out);
+    return false;
+  }
+  return true;
+}
+
+void gonio_trace_free(gonio_trace_t *t)
+{
+  free(t->rows);
+  t->rows = NULL;
+  t->count = 0;
+}
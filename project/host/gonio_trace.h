@@ -0,0 +1,51 @@
+/**
+ * @file		gonio_trace.h
+ * @brief		用于定义抽象该模块的结构体以及声明操作该模块的函数
+ * @note		主机工具：读取录制/合成的角度捕获序列（CSV）
+ * @author	王广平
+ *
+ * @note
+ * 文件格式：每行 t_us,period,high[,truth]
+ * - t_us：捕获时间戳（us），递增
+ * - period/high：TIM3 捕获的周期与高电平宽度（tick）
+ * - truth：可选，理想判定的状态 C/L/R，用于计算检测延时
+ * '#' 开头为注释行，其中 "# tick_hz=<n>" 给出捕获计数频率。
+ **/
+
+#ifndef __GONIO_TRACE_H
+#define __GONIO_TRACE_H
+
+/* 头文件引用 */
+#include "__port_type__.h"
+#include "app_state.h"
+#include <stdbool.h>
+
+/* 一次捕获 */
+typedef struct
+{
+  u32 t_us;
+  u32 period;
+  u32 high;
+  s8 truth; /* app_steer_state_t，-1 表示没有标注 */
+} gonio_trace_row_t;
+
+/* 一段捕获序列 */
+typedef struct
+{
+  gonio_trace_row_t *rows;
+  u32 count;
+  u32 tick_hz;     /* 0 表示文件头没有给出 */
+  bool has_truth;  /* 每一行都有标注 */
+} gonio_trace_t;
+
+/**
+ * @brief		读取捕获序列
+ * @param		path	CSV 文件路径
+ * @param		out		输出，成功后由 gonio_trace_free() 释放
+ * @return	是否成功，失败时已向 stderr 打印原因
+ **/
+bool gonio_trace_load(const char *path, gonio_trace_t *out);
+
+void gonio_trace_free(gonio_trace_t *t);
+
+#endif
@@ -0,0 +1,17 @@
+# 运行回放工具并与期望输出比较
+# 参数：EXE TRACE EXPECT OUT
+execute_process(
+  COMMAND ${EXE} -r 0 ${TRACE}
+  OUTPUT_FILE ${OUT}
+  RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "${EXE} failed: ${rc}")
+endif()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT} ${EXPECT}
+  RESULT_VARIABLE diff)
+if(NOT diff EQUAL 0)
+  file(READ ${OUT} got)
+  message(FATAL_ERROR "output differs from ${EXPECT}:\n${got}")
+endif()
@@ -0,0 +1,228 @@
+/**
+ * @file		test_gonio_spi.c
+ * @brief		主机测试：SPI 绝对编码器角度源的帧解码与多圈展开
+ * @note		用假的 AS5048A 生成有效帧、校验错误帧与错误标志帧，
+ *					驱动 app_gonio_core_spi_frame()/app_gonio_core_spi_sample()
+ * @author	王广平
+ */
+
+/* 头文件引用 */
+#include "app_gonio_core.h"
+#include <stdio.h>
+
+static u32 test_failed = 0;
+
+#define TEST_EXPECT(cond)                                                      \
+  do                                                                           \
+  {                                                                            \
+    if (!(cond))                                                               \
+    {                                                                          \
+      printf("%s:%d: FAILED: %s\n", __FILE__, __LINE__, #cond);              \
+      test_failed++;                                                           \
+    }                                                                          \
+  } while (0)
+
+#define TEST_EXPECT_NEAR(a, b, tol) \
+  TEST_EXPECT(((a) - (b)) <= (tol) && ((b) - (a)) <= (tol))
+
+/* ============================== 假传感器 ============================== */
+/**
+ * @brief 假的 AS5048A：方向盘的连续角度与读取时钟
+ * @note 帧格式：bit15 偶校验，bit14 错误标志，bit13:0 角度
+ */
+typedef struct
+{
+  s32 angle_cdeg; /* 连续角度，可超过一圈 */
+  u32 t_us;
+} fake_as5048a_t;
+
+#define FAKE_PERIOD_US 500U /* 2kHz，同 GONIO_SPI_RATE_HZ */
+
+static u16 fake_as5048a_encode(s32 angle_cdeg, bool ef, bool bad_parity)
+{
+  s32 abs_cdeg = angle_cdeg % GONIO_CDEG_360;
+  if (abs_cdeg < 0)
+    abs_cdeg += GONIO_CDEG_360;
+
+  u32 raw = ((u32)abs_cdeg * 16384U + GONIO_CDEG_360 / 2U) / GONIO_CDEG_360;
+  u32 frame = (raw & 0x3FFFU) | (ef ? 0x4000U : 0U);
+  u32 ones = 0;
+  for (u32 x = frame; x != 0U; x >>= 1)
+    ones += x & 1U;
+  if ((ones & 1U) != (bad_parity ? 0U : 1U))
+    return (u16)frame;
+  return (u16)(frame | 0x8000U);
+}
+
+/* 读取一帧：时钟前进一个读取周期 */
+static u16 fake_as5048a_read(fake_as5048a_t *s, bool ef, bool bad_parity)
+{
+  s->t_us += FAKE_PERIOD_US;
+  return fake_as5048a_encode(s->angle_cdeg, ef, bad_parity);
+}
+
+/* ============================== 测试 ============================== */
+static void test_frame_decode(void)
+{
+  s32 a = -1;
+
+  TEST_EXPECT(app_gonio_core_spi_frame(fake_as5048a_encode(0, false, false),
+                                       false, &a) == GONIO_SPI_FRAME_OK);
+  TEST_EXPECT(a == 0);
+
+  /* 0x2000 = 180°，0x3FFF 为一圈的最后一个刻度 */
+  TEST_EXPECT(app_gonio_core_spi_frame(0x2000U | 0x8000U, false, &a) ==
+              GONIO_SPI_FRAME_OK);
+  TEST_EXPECT(a == 18000);
+  TEST_EXPECT(app_gonio_core_spi_frame(0x3FFFU, false, &a) ==
+              GONIO_SPI_FRAME_OK);
+  TEST_EXPECT(a == 35998);
+
+  /* 取反：0 仍为 0，90° 变为 270° */
+  TEST_EXPECT(app_gonio_core_spi_frame(fake_as5048a_encode(0, false, false),
+                                       true, &a) == GONIO_SPI_FRAME_OK);
+  TEST_EXPECT(a == 0);
+  TEST_EXPECT(app_gonio_core_spi_frame(
+                  fake_as5048a_encode(9000, false, false), true, &a) ==
+              GONIO_SPI_FRAME_OK);
+  TEST_EXPECT(a == 27000);
+
+  /* 每个刻度往返误差不超过半个刻度（36000/16384/2） */
+  for (s32 cdeg = 0; cdeg < GONIO_CDEG_360; cdeg += 7)
+  {
+    a = -1;
+    TEST_EXPECT(app_gonio_core_spi_frame(
+                    fake_as5048a_encode(cdeg, false, false), false, &a) ==
+                GONIO_SPI_FRAME_OK);
+    if (cdeg < GONIO_CDEG_360 - 1)
+      TEST_EXPECT_NEAR(a, cdeg, 2);
+  }
+}
+
+static void test_frame_errors(void)
+{
+  s32 a = 1234;
+
+  /* 校验错误与错误标志都不写出角度 */
+  TEST_EXPECT(app_gonio_core_spi_frame(fake_as5048a_encode(4500, false, true),
+                                       false, &a) == GONIO_SPI_FRAME_PARITY);
+  TEST_EXPECT(app_gonio_core_spi_frame(fake_as5048a_encode(4500, true, false),
+                                       false, &a) == GONIO_SPI_FRAME_EF);
+  TEST_EXPECT(a == 1234);
+
+  /* 错误标志帧同时校验错误时按校验错误计 */
+  TEST_EXPECT(app_gonio_core_spi_frame(fake_as5048a_encode(4500, true, true),
+                                       false, &a) == GONIO_SPI_FRAME_PARITY);
+
+  /* 单个位翻转一定能被偶校验发现 */
+  u16 good = fake_as5048a_encode(12345, false, false);
+  for (u32 bit = 0; bit < 16U; bit++)
+    TEST_EXPECT(app_gonio_core_spi_frame((u16)(good ^ (1U << bit)), false,
+                                         &a) == GONIO_SPI_FRAME_PARITY);
+}
+
+/**
+ * @brief 转动 1.5 圈并跨越 0°/360°，中间夹杂错误帧，展开后的角度应连续
+ */
+static void test_sample_unwrap(void)
+{
+  fake_as5048a_t s = {.angle_cdeg = 35000, .t_us = 0};
+  app_gonio_unwrap_t u = {.prev_abs = -1};
+  s32 zero = 35000;
+  u32 n_ok = 0, n_parity = 0, n_ef = 0;
+  u32 sent_parity = 0, sent_ef = 0;
+
+  app_gonio_core_unwrap_init(&u);
+
+  /* 1000°/s，每帧 0.5°，共 1.5 圈 */
+  for (u32 i = 0; i < 1080U; i++)
+  {
+    bool parity = (i % 7U) == 3U;
+    bool ef = !parity && (i % 11U) == 5U;
+    s32 a = -1;
+
+    sent_parity += parity ? 1U : 0U;
+    sent_ef += ef ? 1U : 0U;
+    s.angle_cdeg += 50;
+    switch (app_gonio_core_spi_sample(&u, fake_as5048a_read(&s, ef, parity),
+                                      false, s.t_us, &a))
+    {
+    case GONIO_SPI_FRAME_OK:
+      n_ok++;
+      TEST_EXPECT_NEAR(app_gonio_core_unwrap_rel(u.base_abs, u.acc, zero),
+                       s.angle_cdeg - 35000, 2);
+      break;
+    case GONIO_SPI_FRAME_PARITY:
+      n_parity++;
+      break;
+    case GONIO_SPI_FRAME_EF:
+      n_ef++;
+      break;
+    default:
+      TEST_EXPECT(!"unexpected reject");
+      break;
+    }
+  }
+
+  TEST_EXPECT(n_parity == sent_parity);
+  TEST_EXPECT(n_ef == sent_ef);
+  TEST_EXPECT(n_ok == 1080U - sent_parity - sent_ef);
+  TEST_EXPECT(u.rejects == 0U);
+  TEST_EXPECT_NEAR(app_gonio_core_unwrap_rel(u.base_abs, u.acc, zero), 54000,
+                   2);
+}
+
+/**
+ * @brief 校验正确但角度跳变的帧（磁铁干扰）被展开拒绝，累加值不变
+ */
+static void test_sample_glitch(void)
+{
+  fake_as5048a_t s = {.angle_cdeg = 1000, .t_us = 0};
+  app_gonio_unwrap_t u = {.prev_abs = -1};
+  s32 a = -1;
+
+  app_gonio_core_unwrap_init(&u);
+  TEST_EXPECT(app_gonio_core_spi_sample(&u, fake_as5048a_read(&s, false, false),
+                                        false, s.t_us, &a) ==
+              GONIO_SPI_FRAME_OK);
+  s32 acc = u.acc;
+
+  u16 glitch = fake_as5048a_encode(s.angle_cdeg + 9000, false, false);
+  s.t_us += FAKE_PERIOD_US;
+  TEST_EXPECT(app_gonio_core_spi_sample(&u, glitch, false, s.t_us, &a) ==
+              GONIO_SPI_FRAME_REJECT);
+  TEST_EXPECT(u.acc == acc);
+  TEST_EXPECT(u.rejects == 1U);
+
+  s.angle_cdeg += 100;
+  TEST_EXPECT(app_gonio_core_spi_sample(&u, fake_as5048a_read(&s, false, false),
+                                        false, s.t_us, &a) ==
+              GONIO_SPI_FRAME_OK);
+  TEST_EXPECT_NEAR(u.acc, acc + 100, 2);
+
+  /* 读数中断 100ms 期间转过 90°：阈值随时间间隔放宽，直接接受 */
+  s.angle_cdeg += 9000;
+  s.t_us += 100000U;
+  acc = u.acc;
+  TEST_EXPECT(app_gonio_core_spi_sample(&u, fake_as5048a_read(&s, false, false),
+                                        false, s.t_us, &a) ==
+              GONIO_SPI_FRAME_OK);
+  TEST_EXPECT_NEAR(u.acc, acc + 9000, 2);
+  TEST_EXPECT(u.rejects == 1U);
+}
+
+int main(void)
+{
+  test_frame_decode();
+  test_frame_errors();
+  test_sample_unwrap();
+  test_sample_glitch();
+
+  if (test_failed != 0U)
+  {
+    printf("test_gonio_spi: %lu failed\n", (unsigned long)test_failed);
+    return 1;
+  }
+  printf("test_gonio_spi: ok\n");
+  return 0;
+}
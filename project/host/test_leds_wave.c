@@ -0,0 +1,168 @@
+/**
+ * @file		test_leds_wave.c
+ * @brief		主机测试：氛围灯带位波形编码与分块调度
+ * @note		检查比较值（0/1 码的高电平与位周期）、高位先发、
+ *					最后一块补零以及半缓冲区乒乓调度的复位间隔
+ * @author	王广平
+ */
+
+/* 头文件引用 */
+#include "app_leds_wave.h"
+#include <stdio.h>
+#include <string.h>
+
+static u32 test_failed = 0;
+
+#define TEST_EXPECT(cond)                                                      \
+  do                                                                           \
+  {                                                                            \
+    if (!(cond))                                                               \
+    {                                                                          \
+      printf("%s:%d: FAILED: %s\n", __FILE__, __LINE__, #cond);              \
+      test_failed++;                                                           \
+    }                                                                          \
+  } while (0)
+
+#define TEST_LEDS_MAX 240U
+
+static u8 lut_identity[256];
+static u8 lut_invert[256];
+
+/* tick 换算为 ns（四舍五入） */
+static u32 ticks_to_ns(u32 ticks)
+{
+  return (u32)(((unsigned long long)ticks * 1000000000ULL + LEDS_TIM_HZ / 2U) /
+               LEDS_TIM_HZ);
+}
+
+/* 一字节的期望比较值，高位先发 */
+static void expect_byte(u8 v, u8 out[8])
+{
+  for (u32 b = 0; b < 8U; b++)
+    out[b] = (v & (0x80U >> b)) ? (u8)LEDS_T1H_TICKS : (u8)LEDS_T0H_TICKS;
+}
+
+static void test_timing(void)
+{
+  TEST_EXPECT(LEDS_BIT_TICKS == 90U);
+  TEST_EXPECT(LEDS_T0H_TICKS == 29U);
+  TEST_EXPECT(LEDS_T1H_TICKS == 58U);
+  TEST_EXPECT(ticks_to_ns(LEDS_BIT_TICKS) == 1250U);
+  TEST_EXPECT(ticks_to_ns(LEDS_T0H_TICKS) == 403U);
+  TEST_EXPECT(ticks_to_ns(LEDS_T1H_TICKS) == 806U);
+}
+
+static void test_encode(void)
+{
+  /* 一颗灯珠：G=0xA5 R=0x00 B=0xFF */
+  const u8 grb[3] = {0xA5U, 0x00U, 0xFFU};
+  const u8 a5[8] = {58, 29, 58, 29, 29, 58, 29, 58};
+  u32 words[6];
+  const u8 *bits = (const u8 *)words;
+  u8 want[8];
+
+  app_leds_encode(grb, 3U, lut_identity, words);
+  TEST_EXPECT(memcmp(bits, a5, 8U) == 0);
+  for (u32 b = 0; b < 8U; b++)
+  {
+    TEST_EXPECT(bits[8U + b] == LEDS_T0H_TICKS);
+    TEST_EXPECT(bits[16U + b] == LEDS_T1H_TICKS);
+  }
+
+  /* 查找表在编码前生效 */
+  app_leds_encode(grb, 3U, lut_invert, words);
+  for (u32 i = 0; i < 3U; i++)
+  {
+    expect_byte((u8)(255U - grb[i]), want);
+    TEST_EXPECT(memcmp(&bits[i * 8U], want, 8U) == 0);
+  }
+}
+
+/**
+ * @brief 模拟 DMA 循环播放两个半缓冲区，收集实际输出的比较值序列
+ * @return 播放的块数
+ */
+static u32 play(const u8 *frame, u32 leds, u8 *stream, u32 stream_cap)
+{
+  static u32 half[2][LEDS_CHUNK_WORDS];
+  app_leds_wave_t w;
+  u32 len = 0;
+  u32 played = 0;
+  bool more = true;
+
+  app_leds_wave_start(&w, frame, leds, lut_identity, half[0], half[1]);
+  while (more && len + LEDS_CHUNK_BITS <= stream_cap)
+  {
+    u32 h = played & 1U;
+    memcpy(&stream[len], half[h], LEDS_CHUNK_BITS);
+    len += LEDS_CHUNK_BITS;
+    played++;
+    more = app_leds_wave_chunk_done(&w, half[h]);
+  }
+  TEST_EXPECT(!more);
+  return played;
+}
+
+static void test_schedule(u32 leds)
+{
+  static u8 frame[TEST_LEDS_MAX * 3U];
+  static u8 stream[(TEST_LEDS_MAX / LEDS_CHUNK_LEDS + 8U) * LEDS_CHUNK_BITS];
+  u32 chunks = (leds + LEDS_CHUNK_LEDS - 1U) / LEDS_CHUNK_LEDS;
+  u8 want[8];
+
+  for (u32 i = 0; i < leds * 3U; i++)
+    frame[i] = (u8)(i * 37U + 11U);
+  memset(stream, 0xEE, sizeof(stream));
+
+  u32 played = play(frame, leds, stream, sizeof(stream));
+  TEST_EXPECT(played == chunks + LEDS_RESET_CHUNKS);
+
+  /* 数据按字节顺序、高位先发，跨越每个块边界都连续 */
+  u32 bad = 0;
+  for (u32 i = 0; i < leds * 3U; i++)
+  {
+    expect_byte(frame[i], want);
+    bad += memcmp(&stream[i * 8U], want, 8U) != 0;
+  }
+  TEST_EXPECT(bad == 0U);
+
+  /* 最后一块的剩余部分与复位块全为 0（整位低电平） */
+  u32 data_bits = leds * 24U;
+  u32 total_bits = played * LEDS_CHUNK_BITS;
+  u32 nonzero = 0;
+  for (u32 i = data_bits; i < total_bits; i++)
+    nonzero += stream[i] != 0U;
+  TEST_EXPECT(nonzero == 0U);
+
+  /*
+   * 停止 DMA 时最后一块的最后一位还没有输出，
+   * 扣掉一块后剩余的低电平仍须不短于 LEDS_RESET_US
+   */
+  u32 low_ns = (total_bits - data_bits - LEDS_CHUNK_BITS) * 1250U;
+  TEST_EXPECT(low_ns >= LEDS_RESET_US * 1000U);
+}
+
+int main(void)
+{
+  for (u32 i = 0; i < 256U; i++)
+  {
+    lut_identity[i] = (u8)i;
+    lut_invert[i] = (u8)(255U - i);
+  }
+
+  test_timing();
+  test_encode();
+  test_schedule(1U);
+  test_schedule(LEDS_CHUNK_LEDS);
+  test_schedule(LEDS_CHUNK_LEDS + 1U);
+  test_schedule(20U);
+  test_schedule(TEST_LEDS_MAX);
+
+  if (test_failed != 0U)
+  {
+    printf("test_leds_wave: %lu failed\n", (unsigned long)test_failed);
+    return 1;
+  }
+  printf("test_leds_wave: ok\n");
+  return 0;
+}
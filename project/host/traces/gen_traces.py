@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+生成 gonio_replay 使用的合成捕获序列（固定随机种子，结果可复现）。
+
+每行 t_us,period,high,truth：
+- period/high 为 TIM3 捕获值（tick_hz 见文件头），按高电平宽度编码绝对角度
+- truth 为理想判定（无延时）的状态：越过 ±90° 为 L/R，回到 ±30° 以内为 C
+
+用法：python3 gen_traces.py [输出目录]
+"""
+
+import math
+import os
+import random
+import sys
+
+TICK_HZ = 36000000  # 1kHz PWM 时 TIM3 的计数频率（72MHz / 2）
+PWM_HZ = 1000
+ZERO_DEG = 200.0  # 方向盘 0 点对应的传感器绝对角度，转过 160° 即跨越 0°/360°
+TURN_ON = 90.0
+CENTER = 30.0
+
+
+def profile(points):
+    """分段线性的方向盘角度（度）：points 为 [(t_ms, deg), ...]"""
+
+    def f(t_ms):
+        if t_ms <= points[0][0]:
+            return points[0][1]
+        for (t0, a0), (t1, a1) in zip(points, points[1:]):
+            if t_ms <= t1:
+                return a0 + (a1 - a0) * (t_ms - t0) / (t1 - t0)
+        return points[-1][1]
+
+    return f, points[-1][0]
+
+
+def truth_label(prev, deg):
+    if deg >= TURN_ON:
+        return "L"
+    if deg <= -TURN_ON:
+        return "R"
+    if abs(deg) <= CENTER:
+        return "C"
+    return prev
+
+
+def write_trace(path, title, angle_fn, length_ms, noise_deg=0.0, glitch=None,
+                seed=1):
+    rng = random.Random(seed)
+    period_nom = TICK_HZ // PWM_HZ
+    truth = "C"
+    t_us = 0
+    with open(path, "w", newline="\n") as f:
+        f.write("# " + title + "\n")
+        f.write("# tick_hz=%d\n" % TICK_HZ)
+        f.write("# t_us,period,high,truth\n")
+        while t_us <= length_ms * 1000:
+            deg = angle_fn(t_us / 1000.0)
+            truth = truth_label(truth, deg)
+
+            meas = deg + (rng.gauss(0.0, noise_deg) if noise_deg > 0 else 0.0)
+            if glitch is not None:
+                meas += glitch(rng)
+
+            period = period_nom + rng.randint(-2, 2)
+            duty = math.fmod(ZERO_DEG + meas, 360.0) / 360.0
+            if duty < 0:
+                duty += 1.0
+            high = max(1, min(period - 1, int(round(duty * period))))
+            f.write("%d,%d,%d,%s\n" % (t_us, period, high, truth))
+            t_us += period * 1000000 // TICK_HZ
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(
+        os.path.abspath(__file__))
+
+    # 慢速左转（不触发预测）与快速右转到满舵 1.5 圈（触发预测，跨越 0°/360°）
+    clean, clean_len = profile([
+        (0, 0), (1000, 0), (2000, 120), (3000, 120), (3500, 0), (4000, 0),
+        (4400, -540), (5500, -540), (6500, 0), (7000, 0)])
+    write_trace(os.path.join(out, "steer_clean.csv"),
+                "slow left turn, fast right turn to full lock",
+                clean, clean_len, noise_deg=0.05, seed=1)
+
+    # 快速左转后停在阈值以内：预测提交后须在 confirm_ms 后撤销
+    stop, stop_len = profile([
+        (0, 0), (500, 0), (900, 80), (2500, 80), (2900, 0), (3500, 0)])
+    write_trace(os.path.join(out, "predict_stop.csv"),
+                "fast left turn stopping at 80 degrees (predicted, then cancelled)",
+                stop, stop_len, noise_deg=0.02, seed=2)
+
+    # 停在阈值附近并带毛刺：单个样本跳回阈值另一侧会重置候选状态的计时，
+    # 用于比较滤波前后的稳定判定延时。毛刺 4° 加噪声仍小于多圈展开的 5° 下限，
+    # 全部到达滤波器（回放输出 unwrap_rej=0）；停在 ±90.5°/±29.5°，
+    # 毛刺足以越过放宽 3° 后的阈值
+    hover, hover_len = profile([
+        (0, 0), (1000, 0), (2000, 90.5), (4000, 90.5), (4800, 29.5),
+        (6500, 29.5), (7500, -90.5), (9500, -90.5), (10300, -29.5),
+        (12000, -29.5), (12500, 0), (13500, 0)])
+
+    last_spike = [False]
+
+    def spike(rng):
+        # 毛刺只持续一个样本：紧跟在毛刺之后的样本不再出毛刺，
+        # 否则一正一负两个毛刺相邻就是 8° 的跳变
+        hit = not last_spike[0] and rng.random() < 0.03
+        last_spike[0] = hit
+        if hit:
+            return 4.0 if rng.random() < 0.5 else -4.0
+        return 0.0
+
+    write_trace(os.path.join(out, "hover_noisy.csv"),
+                "hovering near the thresholds with noise and single-sample spikes",
+                hover, hover_len, noise_deg=0.2, glitch=spike, seed=3)
+
+
+if __name__ == "__main__":
+    main()